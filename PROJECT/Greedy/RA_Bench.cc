@@ -0,0 +1,209 @@
+// File RA_Bench.cc
+// Benchmark of the inner loop of the local search, on the greedy state of an instance:
+//  - full sweeps of the neighborhood, each move evaluated by the delta function of the
+//    neighborhood explorer, as the runners do;
+//  - with --bench::method, runs of the runner for a fixed number of evaluations.
+// --bench::evaluator components runs the same benchmark with one delta cost component per
+// constraint instead of the fused ones, for comparison.
+// --bench::check n first checks, along a random walk of n moves, that the fused evaluators agree
+// with the per-component ones, move by move and on the full cost of the states reached (exit
+// status 1 otherwise).
+// Meant to be run under perf, with and without the load-time reordering, e.g. on an instance
+// made by RA_Generate:
+//   perf stat -e cache-references,cache-misses ./ra_bench --bench::instance big.txt --bench::sweeps 50
+//   perf stat -e cache-references,cache-misses ./ra_bench --bench::instance big.txt --bench::sweeps 50 --bench::reorder true
+// perf counts the setup too (reading the instance, greedy state): a run with --bench::sweeps 0
+// gives its share.
+// Compiled with -DRA_COUNT_ALLOCATIONS, it counts the heap allocations of the sweeps and of the
+// runner loop. The runner is run twice from the same state and seed, for n and for 2n
+// evaluations, and the difference is reported, so that the setup of a run is not counted (the
+// runner options must not stop the runs earlier).
+// RA_Bench.cc has its own main(), so it is linked apart from RA_Main.cc (see there)
+#include "RA_Solver.hh"
+#include <chrono>
+#include <sstream>
+
+using namespace EasyLocal::Debug;
+
+#ifdef RA_COUNT_ALLOCATIONS
+#include <atomic>
+#include <new>
+
+static atomic<unsigned long> allocations(0);
+
+void* operator new(size_t size)
+{
+  allocations++;
+  if (void* p = malloc(size ? size : 1))
+    return p;
+  throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+#endif
+
+// Heap allocations so far (always 0 if they are not counted)
+static unsigned long Allocations()
+{
+#ifdef RA_COUNT_ALLOCATIONS
+  return allocations;
+#else
+  return 0;
+#endif
+}
+
+#ifdef RA_COUNT_ALLOCATIONS
+static const bool counting_allocations = true;
+#else
+static const bool counting_allocations = false;
+#endif
+
+// One full enumeration of the neighborhood of st, each move evaluated by the delta cost
+// components registered in the explorer; returns the number of moves, and adds the deltas
+// to delta (so that the evaluations cannot be optimized away)
+static unsigned long Sweep(const RA_Solver& ra, const RA_Output& st, long& delta)
+{
+  unsigned long moves = 0;
+  RA_Change mv;
+
+  ra.nhe.FirstMove(st, mv);
+  do
+    {
+      delta += ra.nhe.DeltaCostFunctionComponents(st, mv).total;
+      moves++;
+    }
+  while (ra.nhe.NextMove(st, mv));
+  return moves;
+}
+
+// The hard and soft deltas of the fused evaluators against the weighted sums of the
+// per-component ones, on n random moves (each one then made), and the same for the full costs
+// every 100 moves; returns the number of mismatches, after printing the first ones
+static unsigned CheckFused(RA_Solver& ra, RA_Output st, unsigned n)
+{
+  const CostComponent<RA_Input,RA_Output>* components[] =
+    { &ra.cc1, &ra.cc2, &ra.cc3, &ra.cc4, &ra.cc5, &ra.cc6, &ra.cc7, &ra.cc8 };
+  const DeltaCostComponent<RA_Input,RA_Output,RA_Change>* deltas[] =
+    { &ra.dcc1, &ra.dcc2, &ra.dcc3, &ra.dcc4, &ra.dcc5, &ra.dcc6, &ra.dcc7, &ra.dcc8 };
+  unsigned mismatches = 0, i, k;
+  RA_Change mv;
+
+  auto Compare = [&mismatches](const string& what, int fused, int components)
+  {
+    if (fused != components && ++mismatches <= 10)
+      cerr << what << ": fused " << fused << ", per component " << components << endl;
+  };
+  for (i = 0; i <= n; i++)
+    {
+      if (i % 100 == 0 || i == n)
+        {
+          int hard = 0, soft = 0;
+          for (k = 0; k < 8; k++)
+            (components[k]->IsHard() ? hard : soft) += components[k]->Weight() * components[k]->ComputeCost(st);
+          Compare("Hard cost after " + to_string(i) + " moves", ra.hard_cc.ComputeCost(st), hard);
+          Compare("Soft cost after " + to_string(i) + " moves", ra.soft_cc.ComputeCost(st), soft);
+        }
+      if (i == n)
+        break;
+      ra.nhe.RandomMove(st, mv);
+      int hard = 0, soft = 0;
+      for (k = 0; k < 8; k++)
+        (components[k]->IsHard() ? hard : soft) += components[k]->Weight() * deltas[k]->ComputeDeltaCost(st, mv);
+      ostringstream move;
+      move << "Move " << i + 1 << " (" << mv << ")";
+      Compare(move.str() + ", hard delta", ra.hard_dcc.ComputeDeltaCost(st, mv), hard);
+      Compare(move.str() + ", soft delta", ra.soft_dcc.ComputeDeltaCost(st, mv), soft);
+      ra.nhe.MakeMove(st, mv);
+    }
+  return mismatches;
+}
+
+int main(int argc, const char* argv[])
+{
+  ParameterBox bench_parameters("bench", "Benchmark options");
+  Parameter<string> instance("instance", "Input instance", bench_parameters);
+  Parameter<unsigned> sweeps("sweeps", "Full sweeps of the neighborhood (default 10)", bench_parameters);
+  Parameter<bool> reorder("reorder", "Store games by date/time/arena and referees by location", bench_parameters);
+  Parameter<string> evaluator("evaluator", "Delta cost components of the explorer: fused (default) or components", bench_parameters);
+  Parameter<unsigned> check("check", "Check the fused evaluators against the per-component ones on this many random moves", bench_parameters);
+  Parameter<int> balance_weight("balance_weight", "Weight of the referee workload balance (default 0 = off)", bench_parameters);
+  Parameter<string> method("method", "Also run this runner (HC, SD or SA) for a fixed number of evaluations", bench_parameters);
+  Parameter<unsigned> evaluations("evaluations", "Evaluations of the runner runs (default 100000)", bench_parameters);
+  Parameter<int> seed("seed", "Random seed of the runner runs", bench_parameters);
+
+  CommandLineParameters::Parse(argc, argv, false, true);
+  if (!instance.IsSet())
+    {
+      cout << "Error: --bench::instance option must always be set" << endl;
+      return 1;
+    }
+
+  string evaluation = evaluator.IsSet() ? static_cast<string>(evaluator) : "fused";
+  if (evaluation != "fused" && evaluation != "components")
+    {
+      cout << "Error: unknown evaluator " << evaluation << endl;
+      return 1;
+    }
+
+  RA_Input in(instance, reorder.IsSet() && reorder);
+  RA_Solver ra(in, evaluation == "fused", balance_weight.IsSet() ? static_cast<int>(balance_weight) : 0);
+  if (method.IsSet() && !ra.SetMethod(method))
+    {
+      cerr << "Unknown method " << static_cast<string>(method) << endl;
+      return 1;
+    }
+  if (!CommandLineParameters::Parse(argc, argv, true, false))
+    return 1;
+
+  RA_Output out(in);
+  unsigned n_sweeps = sweeps.IsSet() ? static_cast<unsigned>(sweeps) : 10;
+  unsigned long moves = 0, start_allocations;
+  long delta = 0;
+
+  ra.sm.GreedyState(out);
+  if (check.IsSet())
+    {
+      Random::SetSeed(seed.IsSet() ? static_cast<int>(seed) : 0);
+      unsigned mismatches = CheckFused(ra, out, check);
+      cout << "Check of the fused evaluators on " << static_cast<unsigned>(check) << " moves: "
+           << (mismatches == 0 ? "ok" : to_string(mismatches) + " mismatches") << endl;
+      if (mismatches > 0)
+        return 1;
+    }
+  start_allocations = Allocations();
+  auto start = chrono::steady_clock::now();
+  for (unsigned i = 0; i < n_sweeps; i++)
+    moves += Sweep(ra, out, delta);
+  double time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  unsigned long sweep_allocations = Allocations() - start_allocations;
+
+  cout << "Games: " << in.Games() << " Referees: " << in.Referees() << " Evaluator: " << evaluation << endl;
+  cout << "Moves: " << moves << " (" << n_sweeps << " sweeps, delta sum " << delta << ")" << endl;
+  cout << "Time: " << time << "s (" << (moves > 0 ? 1e9 * time / moves : 0.0) << " ns per move)" << endl;
+  if (counting_allocations)
+    cout << "Allocations in the sweeps: " << sweep_allocations << endl;
+
+  if (method.IsSet())
+    {
+      unsigned long n = evaluations.IsSet() ? static_cast<unsigned>(evaluations) : 100000, run_allocations[2];
+      double run_time[2];
+      for (unsigned i = 0; i < 2; i++)
+        { // the second run repeats the first one, then goes on for n evaluations more
+          unsigned long max_evaluations = (i + 1) * n;
+          ra.hc.SetParameter("max_evaluations", max_evaluations);
+          ra.sd.SetParameter("max_evaluations", max_evaluations);
+          ra.sa.SetParameter("max_evaluations", max_evaluations);
+          Random::SetSeed(seed.IsSet() ? static_cast<int>(seed) : 0);
+          start_allocations = Allocations();
+          start = chrono::steady_clock::now();
+          ra.solver.Resolve(out);
+          run_time[i] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+          run_allocations[i] = Allocations() - start_allocations;
+        }
+      cout << "Runner: " << n << " evaluations in " << run_time[1] - run_time[0] << "s" << endl;
+      if (counting_allocations)
+        cout << "Allocations in " << n << " evaluations of the runner: " << run_allocations[1] - run_allocations[0] << endl;
+    }
+  return 0;
+}
@@ -0,0 +1,52 @@
+// File RA_Checkpoint.cc
+#include "RA_Checkpoint.hh"
+#include <fstream>
+#include <cstdio>
+
+bool ReadCheckpoint(const string& file_name, RA_Checkpoint& cp, RA_Output& out)
+{
+  string label;
+  RA_Checkpoint read;
+  RA_Output solution(out);
+  ifstream is(file_name);
+  if (!is)
+    return false;
+
+  is >> label >> read.round;               // read "Round: N"
+  is >> label >> read.seed;                // read "Seed: S"
+  is >> label >> read.restart_temperature; // read "RestartTemperature: T"
+  is >> label >> read.iteration;           // read "Iteration: I"
+  is >> label >> read.temperature;         // read "Temperature: T"
+  is >> label >> read.elapsed;             // read "Elapsed: E"
+  is >> label >> read.cost;                // read "Cost: C"
+  if (!is)
+    return false;
+  is >> solution;
+  cp = read;
+  out = solution;
+  return true;
+}
+
+void WriteCheckpoint(const string& file_name, const RA_Checkpoint& cp, const RA_Output& out)
+{
+  string tmp_name = file_name + ".tmp";
+  ofstream os(tmp_name);
+
+  os.precision(17);
+  os << "Round: " << cp.round << "\n";
+  os << "Seed: " << cp.seed << "\n";
+  os << "RestartTemperature: " << cp.restart_temperature << "\n";
+  os << "Iteration: " << cp.iteration << "\n";
+  os << "Temperature: " << cp.temperature << "\n";
+  os << "Elapsed: " << cp.elapsed << "\n";
+  os << "Cost: " << cp.cost << "\n";
+  os << out;
+  os.close();
+  if (!os)
+    {
+      cerr << "Cannot write checkpoint file " << tmp_name << endl;
+      return;
+    }
+  if (rename(tmp_name.c_str(), file_name.c_str()) != 0)
+    cerr << "Cannot rename checkpoint file " << tmp_name << " to " << file_name << endl;
+}
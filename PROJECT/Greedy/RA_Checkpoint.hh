@@ -0,0 +1,23 @@
+// File RA_Checkpoint.hh
+#ifndef RA_CHECKPOINT_HH
+#define RA_CHECKPOINT_HH
+#include "RA_Data.hh"
+
+// Progress of the anytime mode, saved together with the best solution. A run cut at a
+// checkpoint is continued from the best solution, at the saved iteration and temperature
+struct RA_Checkpoint
+{
+  unsigned round;             // Number of calls of the runner so far
+  int seed;                   // Base random seed (call i uses seed + i)
+  double restart_temperature; // Start temperature of the next SA restart (0 = runner default)
+  unsigned long iteration;    // Iteration of the run that was cut (0 = the next call is a new run)
+  double temperature;         // SA temperature of the run that was cut
+  double elapsed;             // Running time spent so far, in seconds
+  int cost;                   // Cost of the best solution
+};
+
+// Returns false (leaving cp and out unchanged) if the file does not exist or cannot be parsed
+bool ReadCheckpoint(const string& file_name, RA_Checkpoint& cp, RA_Output& out);
+// Writes to a temporary file and renames it, so that a crash never leaves a partial checkpoint
+void WriteCheckpoint(const string& file_name, const RA_Checkpoint& cp, const RA_Output& out);
+#endif
@@ -4,12 +4,68 @@
 #include <cmath>
 #include <iostream>
 #include <utility>
+#include <sstream>
+#include <limits>
+#include <algorithm>
+#include <tuple>
+#include <cstdint>
 
-RA_Input::RA_Input(string file_name)
+// Skip the rest of the current line and the following section header line
+static void SkipHeader(istream& is)
+{
+  is >> ws;
+  is.ignore(numeric_limits<streamsize>::max(), '\n');
+}
+
+// Read a list in the form "[a, b, c]" (possibly empty), followed by an optional ','
+static void ReadList(istream& is, vector<string>& items)
+{
+  string list, item;
+  items.clear();
+  is.ignore(numeric_limits<streamsize>::max(), '[');
+  getline(is, list, ']');
+  istringstream iss(list);
+  while (getline(iss >> ws, item, ','))
+  {
+    while (!item.empty() && isspace(static_cast<unsigned char>(item.back())))
+      item.pop_back();
+    if (!item.empty())
+      items.push_back(item);
+  }
+  if (is.peek() == ',')
+    is.ignore();
+}
+
+// Convert a date "d/m/y" into a progressive day number (days from 1/3/0000)
+static unsigned DayNumber(const string& date)
+{
+  unsigned day, month, year;
+  char ch;
+  istringstream is(date);
+  is >> day >> ch >> month >> ch >> year;
+  if (month <= 2)
+  {
+    year--;
+    month += 12;
+  }
+  return 365 * year + year / 4 - year / 100 + year / 400 + (153 * (month - 3) + 2) / 5 + day - 1;
+}
+
+// Convert a time "hh:mm" into minutes from midnight
+static unsigned Minutes(const string& time)
+{
+  unsigned hours, minutes;
+  char ch;
+  istringstream is(time);
+  is >> hours >> ch >> minutes;
+  return 60 * hours + minutes;
+}
+
+RA_Input::RA_Input(string file_name, bool reorder)
 {  
   const unsigned MAX_DIM = 100;
   unsigned d,r,a,t,g;
-  string incompatible_referee, incompatible_teams, unavailable_date, unavailable_time;
+  vector<string> unavailabilities;
   char ch, buffer[MAX_DIM];
 
   ifstream is(file_name);
@@ -36,83 +92,170 @@ RA_Input::RA_Input(string file_name)
   
 
   // read divisions
-  is.ignore(MAX_DIM, '\n');           // ignore the first line (header)
+  SkipHeader(is);                     // ignore the section header
   for (d = 0; d < divisions; d++)
   {
-    is >> divisionsData[d].code >> ch; // read "D1"
-    is.ignore(MAX_DIM, ':');           // ignore the ':' character
+    getline(is >> ws, divisionsData[d].code, ':'); // read "D1:"
     is >> divisionsData[d].min_referees >> ch; // read "MinReferees,"
     is >> divisionsData[d].max_referees >> ch; // read "MaxReferees,"
     is >> divisionsData[d].level >> ch; // read "Level,"
-    is >> divisionsData[d].teams >> ch; // read "Teams"
+    is >> divisionsData[d].teams; // read "Teams"
   }
 
   // read referees
-  is.ignore(MAX_DIM, '\n');           // ignore the first line (header)
+  SkipHeader(is);                     // ignore the section header
   for (r = 0; r < referees; r++)
   {
-    is >> refereesData[r].code >> ch; // read "R1"
+    getline(is >> ws, refereesData[r].code, ','); // read "R1,"
     is >> refereesData[r].level >> ch; // read "Level,"
     is.ignore(MAX_DIM, '(');           // ignore the '(' character
     is >> refereesData[r].coordinates.first >> ch; // read "Coordinates"
-    is >> refereesData[r].coordinates.second >> ch; // read "Coordinates"
+    is >> refereesData[r].coordinates.second; // read "Coordinates"
     is.ignore(MAX_DIM, ')');           // ignore the ')' character
-    is >> refereesData[r].experience >> ch; // read "Experience,"
-    is.ignore(MAX_DIM, '[');            // ignore the '[' character
-    while (is.peek() != ']')            // read incompatible referees
+    is >> ch >> refereesData[r].experience >> ch; // read ", Experience,"
+    ReadList(is, refereesData[r].incompatible_referees); // read "[IncompatibleReferee, ...]"
+    ReadList(is, refereesData[r].incompatible_teams);    // read "[IncompatibleTeam, ...]"
+    ReadList(is, unavailabilities);                      // read "[UnavailableDate UnavailableTime, ...]"
+    for (const auto& u : unavailabilities)
     {
-      is >> incompatible_referee >> ch; // read "IncompatibleReferee,"
-      refereesData[r].incompatible_referees.push_back(incompatible_referee);
-    }
-    is.ignore(MAX_DIM, ']');            // ignore the ']' character
-    is.ignore(MAX_DIM, '[');            // ignore the '[' character
-    while (is.peek() != ']')            // read incompatible teams
-    {
-      is >> incompatible_teams >> ch; // read "IncompatibleTeam,"
-      refereesData[r].incompatible_teams.push_back(incompatible_teams);
-    }
-    is.ignore(MAX_DIM, ']');            // ignore the ']' character
-    is.ignore(MAX_DIM, '[');            // ignore the '[' character
-    while (is.peek() != ']')            // read unavailabilities
-    {
-      is >> unavailable_date >> ch; // read "UnavailableDate,"
-      is >> unavailable_time >> ch; // read "UnavailableTime,"
+      istringstream iss(u);
+      string unavailable_date, unavailable_time;
+      iss >> unavailable_date >> unavailable_time;
       refereesData[r].unavailabilities.push_back(make_pair(unavailable_date, unavailable_time));
+      size_t dash = unavailable_time.find('-');
+      refereesData[r].unavailable_periods.push_back({DayNumber(unavailable_date),
+                                                     Minutes(unavailable_time.substr(0, dash)),
+                                                     Minutes(unavailable_time.substr(dash + 1))});
     }
-    is.ignore(MAX_DIM, ']');            // ignore the ']' character
   }
 
   // read Arenas
-  is.ignore(MAX_DIM, '\n');             // ignore rest of the line
+  SkipHeader(is);                       // ignore the section header
   for(a=0; a < arenas; a++)
   {
-    is >> arenasData[a].code >> ch;
+    is >> arenasData[a].code;
     is.ignore(MAX_DIM, '(');
     is >> arenasData[a].coordinates.first >> ch;
-    is >> arenasData[a].coordinates.second >> ch;
+    is >> arenasData[a].coordinates.second;
     is.ignore(MAX_DIM, ')');
   }
 
   // read teams
-  is.ignore(MAX_DIM, '\n');
+  SkipHeader(is);
   for(t=0; t < teams; t++)
   {
-    is >> teamsData[t].code >> ch;
-    is >> teamsData[t].division_code >> ch;
+    is >> teamsData[t].code;
+    is >> teamsData[t].division_code;
   }
 
   // read Games
-  is.ignore(MAX_DIM, '\n');
+  SkipHeader(is);
   for(g=0; g < games; g++)
   {
-    is >> gamesData[g].homeTeam_code >> ch;
-    is >> gamesData[g].guestTeam_code >> ch;
-    is >> gamesData[g].division_code >> ch;
-    is >> gamesData[g].date >> ch;
-    is >> gamesData[g].time >> ch;
-    is >> gamesData[g].arena_code >> ch;
-    is >> gamesData[g].experience_required >> ch;
+    is >> gamesData[g].homeTeam_code;
+    is >> gamesData[g].guestTeam_code;
+    is >> gamesData[g].division_code;
+    is >> gamesData[g].date;
+    is >> gamesData[g].time;
+    is >> gamesData[g].arena_code;
+    is >> gamesData[g].experience_required;
   }
+  if (!is)
+  {
+    cerr << "Error reading input file " << file_name << endl;
+    exit(1);
+  }
+
+  ComputeIndices();
+  gameAt.resize(games);
+  refereeAt.resize(referees);
+  for (g = 0; g < games; g++)
+    gameAt[g] = g;
+  for (r = 0; r < referees; r++)
+    refereeAt[r] = r;
+  if (reorder)
+    Reorder();
+  gameFileIndex.resize(games);
+  refereeFileIndex.resize(referees);
+  for (g = 0; g < games; g++)
+    gameFileIndex[gameAt[g]] = g;
+  for (r = 0; r < referees; r++)
+    refereeFileIndex[refereeAt[r]] = r;
+  ComputeDistances();
+  ComputeCompatibilities();
+}
+
+// Position of the point (x, y) along the Hilbert curve that covers a 2^order x 2^order grid
+static uint64_t HilbertIndex(uint32_t x, uint32_t y, unsigned order)
+{
+  const uint32_t n = 1u << order;
+  uint64_t d = 0;
+  for (uint32_t s = n / 2; s > 0; s /= 2)
+  {
+    uint32_t rx = (x & s) > 0, ry = (y & s) > 0;
+    d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+    if (ry == 0)
+    { // rotate the quadrant
+      if (rx == 1)
+      {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      swap(x, y);
+    }
+  }
+  return d;
+}
+
+// Sorts the games by (day, time, arena) and the referees by Hilbert order of their coordinates
+// (both stable), recording in gameAt/refereeAt where each element of the file is stored
+void RA_Input::Reorder()
+{
+  const unsigned ORDER = 16;
+  unsigned g, r;
+  vector<unsigned> order(games);
+  vector<Game> sorted_games(games);
+  vector<Referee> sorted_referees(referees);
+  vector<uint64_t> key(referees);
+
+  for (g = 0; g < games; g++)
+    order[g] = g;
+  stable_sort(order.begin(), order.end(), [this](unsigned g1, unsigned g2)
+  {
+    const Game &a = gamesData[g1], &b = gamesData[g2];
+    return make_tuple(a.day, a.start, a.arena) < make_tuple(b.day, b.start, b.arena);
+  });
+  for (g = 0; g < games; g++)
+  {
+    sorted_games[g] = gamesData[order[g]];
+    gameAt[order[g]] = g;
+  }
+  gamesData.swap(sorted_games);
+
+  // coordinates scaled on the bounding box of the referees
+  float min_x = numeric_limits<float>::max(), min_y = min_x, max_x = -min_x, max_y = -min_x;
+  for (const auto& referee : refereesData)
+  {
+    min_x = min(min_x, referee.coordinates.first);
+    max_x = max(max_x, referee.coordinates.first);
+    min_y = min(min_y, referee.coordinates.second);
+    max_y = max(max_y, referee.coordinates.second);
+  }
+  float side = max(max(max_x - min_x, max_y - min_y), 1e-6f), cells = (1u << ORDER) - 1;
+  order.resize(referees);
+  for (r = 0; r < referees; r++)
+  {
+    order[r] = r;
+    key[r] = HilbertIndex(static_cast<uint32_t>((refereesData[r].coordinates.first - min_x) / side * cells),
+                          static_cast<uint32_t>((refereesData[r].coordinates.second - min_y) / side * cells), ORDER);
+  }
+  stable_sort(order.begin(), order.end(), [&key](unsigned r1, unsigned r2) { return key[r1] < key[r2]; });
+  for (r = 0; r < referees; r++)
+  {
+    sorted_referees[r] = refereesData[order[r]];
+    refereeAt[order[r]] = r;
+  }
+  refereesData.swap(sorted_referees);
 }
 
 // Function that fill the distance matrices, using euclidean distance
@@ -138,6 +281,120 @@ void RA_Input::ComputeDistances()
   }
 }
 
+// Function that translates the codes of the games into indices, and dates/times into numbers
+void RA_Input::ComputeIndices()
+{
+  for (auto& game : gamesData)
+  {
+    for (unsigned t = 0; t < teams; t++)
+    {
+      if (teamsData[t].code == game.homeTeam_code)
+        game.homeTeam = t;
+      if (teamsData[t].code == game.guestTeam_code)
+        game.guestTeam = t;
+    }
+    for (unsigned d = 0; d < divisions; d++)
+      if (divisionsData[d].code == game.division_code)
+        game.division = d;
+    for (unsigned a = 0; a < arenas; a++)
+      if (arenasData[a].code == game.arena_code)
+        game.arena = a;
+    game.day = DayNumber(game.date);
+    game.start = Minutes(game.time);
+  }
+}
+
+// Function that fills the compatibility matrices used by the cost components
+void RA_Input::ComputeCompatibilities()
+{
+  refereeAvailable.assign(games * referees, true);
+  refereesIncompatible.assign(referees * referees, false);
+  refereeTeamIncompatible.assign(games * referees, false);
+  gamesOverlap.assign(games * games, false);
+
+  for (unsigned r = 0; r < referees; r++)
+  {
+    for (const auto& code : refereesData[r].incompatible_referees)
+    {
+      int r2 = RefereeIndex(code);
+      if (r2 != -1)
+      { // incompatibility is symmetric, even if it is listed only once
+        refereesIncompatible[r * referees + r2] = true;
+        refereesIncompatible[r2 * referees + r] = true;
+      }
+    }
+    for (unsigned g = 0; g < games; g++)
+    {
+      const Game& game = gamesData[g];
+      for (const auto& code : refereesData[r].incompatible_teams)
+        if (code == game.homeTeam_code || code == game.guestTeam_code)
+          refereeTeamIncompatible[g * referees + r] = true;
+      for (const auto& u : refereesData[r].unavailable_periods)
+        if (u.day == game.day && u.start < game.start + GAME_DURATION && game.start < u.end)
+          refereeAvailable[g * referees + r] = false;
+    }
+  }
+
+  for (unsigned g1 = 0; g1 < games; g1++)
+    for (unsigned g2 = 0; g2 < games; g2++)
+    {
+      const Game& first = gamesData[g1].start <= gamesData[g2].start ? gamesData[g1] : gamesData[g2];
+      const Game& second = gamesData[g1].start <= gamesData[g2].start ? gamesData[g2] : gamesData[g1];
+      if (g1 != g2 && first.day == second.day)
+        gamesOverlap[g1 * games + g2] = first.start + GAME_DURATION
+          + TravelTime(distanceBetweenArenas[first.arena][second.arena]) > second.start;
+    }
+
+  // Bound of the games of each referee: on each day, the most games the referee is available
+  // for whose times do not intersect, taken greedily by starting time (the most, since all the
+  // games last GAME_DURATION); travel times are left out, so that this is an upper bound
+  vector<unsigned> by_time(games);
+  for (unsigned g = 0; g < games; g++)
+    by_time[g] = g;
+  sort(by_time.begin(), by_time.end(), [this](unsigned g1, unsigned g2) { return GameTime(g1) < GameTime(g2); });
+  maxRefereeGames.assign(referees, 0);
+  for (unsigned r = 0; r < referees; r++)
+  {
+    unsigned day = 0, free_from = 0; // free_from: first minute of day after the last game taken
+    for (unsigned g : by_time)
+      if (RefereeAvailable(r, g) && (maxRefereeGames[r] == 0 || GameDay(g) != day || GameStart(g) >= free_from))
+      {
+        maxRefereeGames[r]++;
+        day = GameDay(g);
+        free_from = GameStart(g) + GAME_DURATION;
+      }
+  }
+}
+
+int RA_Input::RefereeIndex(const string& code) const
+{
+  for (unsigned r = 0; r < referees; r++)
+    if (refereesData[r].code == code)
+      return r;
+  return -1;
+}
+
+// In file order: if the same pair plays more than once, the first game of the file
+int RA_Input::GameIndex(const string& home, const string& guest) const
+{
+  for (unsigned i = 0; i < games; i++)
+    if (gamesData[gameAt[i]].homeTeam_code == home && gamesData[gameAt[i]].guestTeam_code == guest)
+      return gameAt[i];
+  return -1;
+}
+
+// Among all the games of the pair, in file order as above
+int RA_Input::GameIndex(const string& home, const string& guest, unsigned day) const
+{
+  for (unsigned i = 0; i < games; i++)
+    {
+      const auto& game = gamesData[gameAt[i]];
+      if (game.day == day && game.homeTeam_code == home && game.guestTeam_code == guest)
+        return gameAt[i];
+    }
+  return -1;
+}
+
 ostream& operator<<(ostream& os, const RA_Input& in)
 {
  
@@ -157,7 +414,8 @@ ostream& operator<<(ostream& os, const RA_Input& in)
 
   // REFEREES
   os << "REFEREES % code, level, coordinates, experience, incompatible referees, incompatible teams, unavailabilities\n";
-  for (const auto& r : in.refereesData) {
+  for (unsigned i = 0; i < in.referees; i++) {
+    const auto& r = in.refereesData[in.RefereeAt(i)];
     os << r.code << ", " << r.level << ", (" << r.coordinates.first << ", " << r.coordinates.second << "), "
        << r.experience << ", [";
     for (size_t i = 0; i < r.incompatible_referees.size(); ++i) {
@@ -194,7 +452,8 @@ ostream& operator<<(ostream& os, const RA_Input& in)
 
   // GAMES
   os << "GAMES % Home team, guest team, division, date, time, arena, experience\n";
-  for (const auto& g : in.gamesData) {
+  for (unsigned i = 0; i < in.games; i++) {
+    const auto& g = in.gamesData[in.GameAt(i)];
     os << g.homeTeam_code << " " << g.guestTeam_code << " " << g.division_code << " "
        << g.date << " " << g.time << " " << g.arena_code << " " << g.experience_required << "\n";
   }
@@ -205,22 +464,131 @@ ostream& operator<<(ostream& os, const RA_Input& in)
 RA_Output::RA_Output(const RA_Input& my_in): in(my_in)
 {
   gameAssignments.resize(in.Games());
+  refereeAssignments.resize(in.Referees());
+  for (unsigned g = 0; g < in.Games(); g++)
+    gameAssignments[g].reserve(in.MaxReferees(g));
+  for (unsigned r = 0; r < in.Referees(); r++)
+    refereeAssignments[r].reserve(in.MaxRefereeGames(r));
+  levels = 0;
+  for (unsigned g = 0; g < in.Games(); g++)
+    levels = max(levels, in.GameLevel(g) + 1);
+  refereeDistance.resize(in.Referees(), 0);
+  refereeLevelGames.resize(in.Referees(), vector<unsigned>(levels, 0));
+  totalGames = 0;
+  totalDistance = 0;
+  squaredGames = 0;
+  squaredDistance = 0;
 } 
 
+RA_Output::RA_Output(const RA_Output& out): RA_Output(out.in)
+{
+  *this = out;
+}
+
 RA_Output& RA_Output::operator=(const RA_Output& out)
 {
   gameAssignments = out.gameAssignments;
+  refereeAssignments = out.refereeAssignments;
+  refereeDistance = out.refereeDistance;
+  refereeLevelGames = out.refereeLevelGames;
+  totalGames = out.totalGames;
+  totalDistance = out.totalDistance;
+  squaredGames = out.squaredGames;
+  squaredDistance = out.squaredDistance;
   return *this;
 }
 
+void RA_Output::AssignRefereetoGame(unsigned game_id, unsigned referee)
+{
+  gameAssignments[game_id].push_back(referee);
+  InsertGame(referee, game_id);
+}
+
+// Keeps the timeline of the referee sorted (within the reserved capacity) and its workload
+void RA_Output::InsertGame(unsigned referee, unsigned game_id)
+{
+  auto& games = refereeAssignments[referee];
+  long long count = games.size(), distance = refereeDistance[referee], delta = TourDelta(referee, game_id);
+  squaredGames += 2 * count + 1;
+  squaredDistance += (2 * distance + delta) * delta;
+  totalGames++;
+  totalDistance += delta;
+  refereeDistance[referee] += delta;
+  refereeLevelGames[referee][in.GameLevel(game_id)]++;
+  games.insert(upper_bound(games.begin(), games.end(), game_id,
+                           [this](unsigned g1, unsigned g2) { return in.GameBefore(g1, g2); }), game_id);
+}
+
 void RA_Output::AssignRefereetoGame(unsigned game_id, const string& referee_code)
 {
-  gameAssignments[game_id].push_back(referee_code);
+  int referee = in.RefereeIndex(referee_code);
+  if (referee == -1)
+  {
+    cerr << "Errore: arbitro " << referee_code << " non trovato\n";
+    exit(1);
+  }
+  AssignRefereetoGame(game_id, static_cast<unsigned>(referee));
+}
+
+void RA_Output::RemoveRefereefromGame(unsigned game_id, unsigned referee)
+{
+  auto& referees = gameAssignments[game_id];
+  referees.erase(find(referees.begin(), referees.end(), referee));
+  EraseGame(referee, game_id);
+}
+
+// Replaces the referee in place, so that the order of the crew is preserved
+void RA_Output::ChangeReferee(unsigned game_id, unsigned old_referee, unsigned new_referee)
+{
+  auto& referees = gameAssignments[game_id];
+  *find(referees.begin(), referees.end(), old_referee) = new_referee;
+  EraseGame(old_referee, game_id);
+  InsertGame(new_referee, game_id);
+}
+
+void RA_Output::EraseGame(unsigned referee, unsigned game_id)
+{
+  auto& games = refereeAssignments[referee];
+  long long count = games.size(), distance = refereeDistance[referee], delta = TourDelta(referee, game_id);
+  squaredGames -= 2 * count - 1;
+  squaredDistance += (delta - 2 * distance) * delta;
+  totalGames--;
+  totalDistance -= delta;
+  refereeDistance[referee] -= delta;
+  refereeLevelGames[referee][in.GameLevel(game_id)]--;
+  games.erase(find(games.begin(), games.end(), game_id));
+}
+
+int RA_Output::PreviousGame(unsigned referee, unsigned game_id) const
+{
+  const auto& games = refereeAssignments[referee];
+  auto it = lower_bound(games.begin(), games.end(), game_id,
+                        [this](unsigned g1, unsigned g2) { return in.GameBefore(g1, g2); });
+  if (it == games.begin() || in.GameDay(*(it - 1)) != in.GameDay(game_id))
+    return -1;
+  return *(it - 1);
+}
+
+int RA_Output::NextGame(unsigned referee, unsigned game_id) const
+{
+  const auto& games = refereeAssignments[referee];
+  auto it = upper_bound(games.begin(), games.end(), game_id,
+                        [this](unsigned g1, unsigned g2) { return in.GameBefore(g1, g2); });
+  if (it == games.end() || in.GameDay(*it) != in.GameDay(game_id))
+    return -1;
+  return *it;
+}
+
+int RA_Output::TourDelta(unsigned referee, unsigned game_id) const
+{
+  int p = PreviousGame(referee, game_id), s = NextGame(referee, game_id);
+  return Leg(in, referee, p, game_id) + Leg(in, referee, game_id, s) - Leg(in, referee, p, s);
 }
 
-const vector<string>& RA_Output::AssignedReferees(unsigned game_id) const
+bool RA_Output::IsAssigned(unsigned game_id, unsigned referee) const
 {
-  return gameAssignments[game_id];
+  const auto& referees = gameAssignments[game_id];
+  return find(referees.begin(), referees.end(), referee) != referees.end();
 }
 
 void RA_Output::Reset()
@@ -229,14 +597,27 @@ void RA_Output::Reset()
   {
     g.clear();
   }
+  for(auto& r : refereeAssignments)
+  {
+    r.clear();
+  }
+  fill(refereeDistance.begin(), refereeDistance.end(), 0);
+  for(auto& l : refereeLevelGames)
+  {
+    fill(l.begin(), l.end(), 0);
+  }
+  totalGames = 0;
+  totalDistance = 0;
+  squaredGames = 0;
+  squaredDistance = 0;
 }
 
 void RA_Output::Dump(ostream& os) const {
-  for (unsigned g = 0; g < in.Games(); ++g) {
-    const auto& game = in.gamesData[g];
-    os << game.homeTeam_code << " " << game.guestTeam_code << " " << gameAssignments[g].size();
-    for (const auto& r : gameAssignments[g])
-      os << " " << r;
+  for (unsigned i = 0; i < in.Games(); ++i) {
+    unsigned g = in.GameAt(i);
+    os << in.GameHomeTeamCode(g) << " " << in.GameGuestTeamCode(g) << " " << gameAssignments[g].size();
+    for (unsigned r : gameAssignments[g])
+      os << " " << in.RefereeCode(r);
     os << "\n";
   }
 }
@@ -252,14 +633,7 @@ istream& operator>>(istream& is, RA_Output& out) {
   string home, guest, referee;
   unsigned num_refs;
   while (is >> home >> guest >> num_refs) {
-    unsigned game_id = -1;
-    for (unsigned g = 0; g < out.in.Games(); ++g) {
-      if (out.in.gamesData[g].homeTeam_code == home &&
-          out.in.gamesData[g].guestTeam_code == guest) {
-        game_id = g;
-        break;
-      }
-    }
+    int game_id = out.in.GameIndex(home, guest);
     if (game_id == -1) {
       cerr << "Errore: partita " << home << "-" << guest << " non trovata\n";
       exit(1);
@@ -283,4 +657,3 @@ bool operator==(const RA_Output& out1, const RA_Output& out2)
   }
   return true;
 }
-
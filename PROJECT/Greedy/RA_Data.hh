@@ -4,6 +4,7 @@
 #include <iostream>
 #include <cstdlib>
 #include <vector>
+#include <string>
 
 using namespace std;
 
@@ -11,19 +12,68 @@ class RA_Input
 {
   friend ostream& operator<<(ostream& os, const RA_Input& in);
 public:
-  RA_Input(string file_name);
-  
+  // reorder = true stores the games by (date, time, arena) and the referees by the Hilbert
+  // order of their coordinates, so that the games of a slot and nearby referees are stored next
+  // to each other (whether this pays off is for RA_Bench to tell, on large instances); the
+  // output always follows the file order
+  RA_Input(string file_name, bool reorder = false);
+
   // Getters for the problem parameters
   unsigned Divisions() const { return divisions; }
   unsigned Referees() const { return referees; }
   unsigned Arenas() const { return arenas; }
   unsigned Teams() const { return teams; }
   unsigned Games() const { return games; }
-  
+
   // Getters for the distance matrices
   float DistanceBetweenArenas(unsigned a1, unsigned a2) const {return distanceBetweenArenas[a1][a2];}
   float DistanceBetweenArenasAndReferee(unsigned a, unsigned r) const {return distanceBetweenArenasAndReferee[a][r];}
+  float DistanceGameReferee(unsigned g, unsigned r) const {return distanceBetweenArenasAndReferee[gamesData[g].arena][r];}
+
+  // Getters for the referees (by index)
+  const string& RefereeCode(unsigned r) const { return refereesData[r].code; }
+  unsigned RefereeLevel(unsigned r) const { return refereesData[r].level; }
+  unsigned RefereeExperience(unsigned r) const { return refereesData[r].experience; }
+  int RefereeIndex(const string& code) const; // -1 if the code is unknown
+
+  // Getters for the games (by index)
+  const string& GameHomeTeamCode(unsigned g) const { return gamesData[g].homeTeam_code; }
+  const string& GameGuestTeamCode(unsigned g) const { return gamesData[g].guestTeam_code; }
+  unsigned GameDivision(unsigned g) const { return gamesData[g].division; }
+  unsigned GameArena(unsigned g) const { return gamesData[g].arena; }
+  unsigned GameDay(unsigned g) const { return gamesData[g].day; }
+  unsigned GameStart(unsigned g) const { return gamesData[g].start; }
+  unsigned GameTime(unsigned g) const { return gamesData[g].day * 1440 + gamesData[g].start; } // minutes
+  const string& GameDate(unsigned g) const { return gamesData[g].date; }     // as in the file, e.g. 5/1/2019
+  const string& GameHour(unsigned g) const { return gamesData[g].time; }     // as in the file, e.g. 21:00
+  // order of the games on the timeline of a referee (by starting time, then by file order)
+  bool GameBefore(unsigned g1, unsigned g2) const
+  { return GameTime(g1) < GameTime(g2) || (GameTime(g1) == GameTime(g2) && gameFileIndex[g1] < gameFileIndex[g2]); }
+  unsigned GameExperience(unsigned g) const { return gamesData[g].experience_required; }
+  unsigned MinReferees(unsigned g) const { return divisionsData[gamesData[g].division].min_referees; }
+  unsigned MaxReferees(unsigned g) const { return divisionsData[gamesData[g].division].max_referees; }
+  unsigned GameLevel(unsigned g) const { return divisionsData[gamesData[g].division].level; }
+  int GameIndex(const string& home, const string& guest) const; // -1 if the game is unknown
+  int GameIndex(const string& home, const string& guest, unsigned day) const; // the game of the pair on that day, -1 if none
+
+  // Mapping between the storage order and the file order
+  unsigned GameAt(unsigned i) const { return gameAt[i]; }               // i-th game of the file
+  unsigned GameFileIndex(unsigned g) const { return gameFileIndex[g]; }
+  unsigned RefereeAt(unsigned i) const { return refereeAt[i]; }         // i-th referee of the file
+  unsigned RefereeFileIndex(unsigned r) const { return refereeFileIndex[r]; }
+
+  // Precomputed compatibility matrices
+  bool RefereeAvailable(unsigned r, unsigned g) const { return refereeAvailable[g * referees + r]; }
+  bool RefereesIncompatible(unsigned r1, unsigned r2) const { return refereesIncompatible[r1 * referees + r2]; }
+  bool RefereeTeamIncompatible(unsigned r, unsigned g) const { return refereeTeamIncompatible[g * referees + r]; }
+  // true if a referee cannot officiate both games, travel time included
+  bool GamesOverlap(unsigned g1, unsigned g2) const { return gamesOverlap[g1 * games + g2]; }
+  // upper bound of the games referee r can officiate while available and without overlaps
+  unsigned MaxRefereeGames(unsigned r) const { return maxRefereeGames[r]; }
 
+  static const unsigned GAME_DURATION = 120; // minutes, fixed for all divisions
+  // travel time in minutes for a given distance (average speed of 60 km/h, i.e. 1 km per minute)
+  static unsigned TravelTime(float distance) { return static_cast<unsigned>(distance + 0.999f); }
 
 private:
   // Problem parameters
@@ -32,6 +82,9 @@ private:
   vector<vector<float>> distanceBetweenArenas;
   vector<vector<float>> distanceBetweenArenasAndReferee;
   void ComputeDistances();
+  void ComputeIndices();
+  void ComputeCompatibilities();
+  void Reorder();
 
   // Division Data structure
   struct Division {
@@ -43,6 +96,12 @@ private:
   };
   vector<Division> divisionsData; // Vector of divisions
 
+  // Unavailability period of a referee, converted from (date, hour range)
+  struct Unavailability {
+    unsigned day;                 // Day number (see DayNumber)
+    unsigned start, end;          // Minutes from midnight
+  };
+
   // Referee Data structure
   struct Referee {
     string code;                                    // R1 Unique identifier for the referee
@@ -52,6 +111,7 @@ private:
     vector<string> incompatible_referees;           // Vector of referees that this referee cannot work with
     vector<string> incompatible_teams;              // Vector of teams that this referee cannot officiate
     vector<pair <string, string>> unavailabilities; // Vector of pairs representing unavailability periods (date, hour)
+    vector<Unavailability> unavailable_periods;     // Same periods, in day/minutes
   };
   vector<Referee> refereesData;                     // Vector of referees
 
@@ -78,26 +138,87 @@ private:
     string time;                  // Time of the game (hour, minute)
     string arena_code;            // A1 Code of the arena where the game is played
     unsigned experience_required;   // INT Minimum level of experience required by the referees for this game
+    unsigned homeTeam, guestTeam, division, arena; // Indices of the codes above
+    unsigned day, start;          // Day number and starting minute of the game
   };
   vector<Game> gamesData;           // Vector of games
 
+  // Storage order -> file order and back
+  vector<unsigned> gameAt, gameFileIndex, refereeAt, refereeFileIndex;
+
+  // Compatibility matrices, one byte per entry in a single block, row by row (games x referees:
+  // the moves of a game try all the referees in a row)
+  vector<unsigned char> refereeAvailable;        // games x referees
+  vector<unsigned char> refereesIncompatible;    // referees x referees
+  vector<unsigned char> refereeTeamIncompatible; // games x referees
+  vector<unsigned char> gamesOverlap;            // games x games
+  vector<unsigned> maxRefereeGames;
 };
 
-class RA_Output 
+// Cost of a leg of the daily tour of referee r, from game g1 to game g2 (-1 = home).
+// Legs are rounded one by one, so that full and delta costs always match
+inline int Leg(const RA_Input& in, unsigned r, int g1, int g2)
+{
+  if (g1 == -1 && g2 == -1)
+    return 0;
+  if (g1 == -1)
+    return static_cast<int>(in.DistanceGameReferee(g2, r) + 0.5f);
+  if (g2 == -1)
+    return static_cast<int>(in.DistanceGameReferee(g1, r) + 0.5f);
+  return static_cast<int>(in.DistanceBetweenArenas(in.GameArena(g1), in.GameArena(g2)) + 0.5f);
+}
+
+// Referees are stored by index; the codes are used only for input and output.
+// The workload of each referee (games, tour distance, games per level) and the sums over the
+// referees of the games, the distances and their squares are kept up to date by the assignment
+// methods. The counters change in constant time, but the timeline of the referee is a sorted
+// vector: a binary search, then an insert or erase linear in the games of the referee
+class RA_Output
 {
   friend ostream& operator<<(ostream& os, const RA_Output& out);
   friend istream& operator>>(istream& is, RA_Output& out);
   friend bool operator==(const RA_Output& out1, const RA_Output& out2);
 public:
   RA_Output(const RA_Input& i);
+  RA_Output(const RA_Output& out); // reserved as a new state, so that the copy never allocates either
   RA_Output& operator=(const RA_Output& out);
 
+  void AssignRefereetoGame(unsigned game_id, unsigned referee);
   void AssignRefereetoGame(unsigned game_id, const string& referee_code);
-  const vector<string>& AssignedReferees(unsigned game_id) const;
+  void RemoveRefereefromGame(unsigned game_id, unsigned referee);
+  void ChangeReferee(unsigned game_id, unsigned old_referee, unsigned new_referee);
+  const vector<unsigned>& AssignedReferees(unsigned game_id) const { return gameAssignments[game_id]; }
+  const vector<unsigned>& RefereeGames(unsigned referee) const { return refereeAssignments[referee]; } // in time order
+  // games of the referee on the same day, just before/after game_id (which may be unassigned); -1 if none
+  int PreviousGame(unsigned referee, unsigned game_id) const;
+  int NextGame(unsigned referee, unsigned game_id) const;
+  // cost of game_id in the daily tour of the referee, whether the game is already on the
+  // timeline (cost of removing it) or not (cost of inserting it)
+  int TourDelta(unsigned referee, unsigned game_id) const;
+  bool IsAssigned(unsigned game_id, unsigned referee) const;
+  unsigned RefereeGameCount(unsigned referee) const { return refereeAssignments[referee].size(); }
+  int RefereeDistance(unsigned referee) const { return refereeDistance[referee]; } // total of the daily tours
+  unsigned RefereeLevelGames(unsigned referee, unsigned level) const { return refereeLevelGames[referee][level]; }
+  unsigned Levels() const { return levels; } // division levels are 0 .. Levels() - 1
+  // sums over all the referees
+  unsigned TotalGames() const { return totalGames; }
+  long long SquaredGames() const { return squaredGames; }
+  int TotalDistance() const { return totalDistance; }
+  long long SquaredDistance() const { return squaredDistance; }
   void Reset();
   void Dump(ostream& os) const;
 private:
   const RA_Input& in;
-  vector<vector<string>> gameAssignments; 
+  void InsertGame(unsigned referee, unsigned game_id);
+  void EraseGame(unsigned referee, unsigned game_id);
+  // Both vectors are reserved at their maximum size, so that assignments never allocate
+  vector<vector<unsigned>> gameAssignments;    // referees assigned to each game
+  vector<vector<unsigned>> refereeAssignments; // games assigned to each referee, sorted by time
+  unsigned levels;
+  vector<int> refereeDistance;                 // referees
+  vector<vector<unsigned>> refereeLevelGames;  // referees x division levels
+  unsigned totalGames;
+  int totalDistance;
+  long long squaredGames, squaredDistance;
 };
 #endif
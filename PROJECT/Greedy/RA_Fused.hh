@@ -0,0 +1,187 @@
+// File RA_Fused.hh
+#ifndef RA_FUSED_HH
+#define RA_FUSED_HH
+
+#include "RA_Helpers.hh"
+
+// Fused evaluation of a group of cost components. The group is given at compile time by a
+// Weights class with one static constexpr int per component (0 = not in the group):
+//   overlap, availability, level, experience, distance, optional,
+//   referee_incompatibility, team_incompatibility
+// The per-component classes in RA_Helpers.hh compute the same costs, one at a time.
+
+template <class Weights>
+int RA_FusedCost(const RA_Input& in, const RA_Output& st)
+{
+  unsigned g, r, i, j, experience;
+  int cost = 0;
+
+  for (g = 0; g < in.Games(); g++)
+    {
+      const auto& referees = st.AssignedReferees(g);
+      experience = 0;
+      for (i = 0; i < referees.size(); i++)
+        {
+          r = referees[i];
+          if constexpr (Weights::availability != 0)
+            if (!in.RefereeAvailable(r, g))
+              cost += Weights::availability;
+          if constexpr (Weights::level != 0)
+            cost += Weights::level * MissingLevel(in, g, r);
+          if constexpr (Weights::team_incompatibility != 0)
+            if (in.RefereeTeamIncompatible(r, g))
+              cost += Weights::team_incompatibility;
+          if constexpr (Weights::referee_incompatibility != 0)
+            for (j = i + 1; j < referees.size(); j++)
+              if (in.RefereesIncompatible(r, referees[j]))
+                cost += Weights::referee_incompatibility;
+          experience += in.RefereeExperience(r);
+        }
+      if constexpr (Weights::experience != 0)
+        cost += Weights::experience * MissingExperience(in, g, experience);
+      if constexpr (Weights::optional != 0)
+        cost += Weights::optional * static_cast<int>(in.MaxReferees(g) - referees.size());
+    }
+
+  if constexpr (Weights::overlap != 0 || Weights::distance != 0)
+    for (r = 0; r < in.Referees(); r++)
+      {
+        const auto& games = st.RefereeGames(r);
+        int previous = -1;
+        for (i = 0; i < games.size(); i++)
+          {
+            if constexpr (Weights::overlap != 0)
+              for (j = i + 1; j < games.size(); j++)
+                if (in.GamesOverlap(games[i], games[j]))
+                  cost += Weights::overlap;
+            if constexpr (Weights::distance != 0)
+              {
+                if (previous != -1 && in.GameDay(previous) != in.GameDay(games[i]))
+                  {
+                    cost += Weights::distance * Leg(in, r, previous, -1);
+                    previous = -1;
+                  }
+                cost += Weights::distance * Leg(in, r, previous, games[i]);
+                previous = games[i];
+              }
+          }
+        if constexpr (Weights::distance != 0)
+          cost += Weights::distance * Leg(in, r, previous, -1);
+      }
+  return cost;
+}
+
+// All the weighted deltas of the group for one move, reading the crew and the
+// timelines of the two referees only once
+template <class Weights>
+int RA_FusedDeltaCost(const RA_Input& in, const RA_Output& st, const RA_Change& mv)
+{
+  int cost = 0;
+  const unsigned g = mv.game;
+
+  // terms that depend only on the referee that leaves and on the one that enters
+  if (mv.old_ref != -1)
+    {
+      if constexpr (Weights::availability != 0)
+        if (!in.RefereeAvailable(mv.old_ref, g))
+          cost -= Weights::availability;
+      if constexpr (Weights::level != 0)
+        cost -= Weights::level * MissingLevel(in, g, mv.old_ref);
+      if constexpr (Weights::team_incompatibility != 0)
+        if (in.RefereeTeamIncompatible(mv.old_ref, g))
+          cost -= Weights::team_incompatibility;
+    }
+  if (mv.new_ref != -1)
+    {
+      if constexpr (Weights::availability != 0)
+        if (!in.RefereeAvailable(mv.new_ref, g))
+          cost += Weights::availability;
+      if constexpr (Weights::level != 0)
+        cost += Weights::level * MissingLevel(in, g, mv.new_ref);
+      if constexpr (Weights::team_incompatibility != 0)
+        if (in.RefereeTeamIncompatible(mv.new_ref, g))
+          cost += Weights::team_incompatibility;
+    }
+  if constexpr (Weights::optional != 0)
+    {
+      if (mv.old_ref == -1)
+        cost -= Weights::optional;
+      else if (mv.new_ref == -1)
+        cost += Weights::optional;
+    }
+
+  // terms that depend on the rest of the crew
+  if constexpr (Weights::experience != 0 || Weights::referee_incompatibility != 0)
+    {
+      unsigned experience = 0, new_experience;
+      for (unsigned r : st.AssignedReferees(g))
+        {
+          if constexpr (Weights::experience != 0)
+            experience += in.RefereeExperience(r);
+          if constexpr (Weights::referee_incompatibility != 0)
+            if (static_cast<int>(r) != mv.old_ref)
+              {
+                if (mv.old_ref != -1 && in.RefereesIncompatible(mv.old_ref, r))
+                  cost -= Weights::referee_incompatibility;
+                if (mv.new_ref != -1 && in.RefereesIncompatible(mv.new_ref, r))
+                  cost += Weights::referee_incompatibility;
+              }
+        }
+      if constexpr (Weights::experience != 0)
+        {
+          new_experience = experience;
+          if (mv.old_ref != -1)
+            new_experience -= in.RefereeExperience(mv.old_ref);
+          if (mv.new_ref != -1)
+            new_experience += in.RefereeExperience(mv.new_ref);
+          cost += Weights::experience * (MissingExperience(in, g, new_experience) - MissingExperience(in, g, experience));
+        }
+    }
+
+  // terms that depend on the timelines of the two referees
+  if constexpr (Weights::distance != 0)
+    {
+      if (mv.old_ref != -1)
+        cost -= Weights::distance * st.TourDelta(mv.old_ref, g);
+      if (mv.new_ref != -1)
+        cost += Weights::distance * st.TourDelta(mv.new_ref, g);
+    }
+  if constexpr (Weights::overlap != 0)
+    {
+      if (mv.old_ref != -1)
+        for (unsigned g2 : st.RefereeGames(mv.old_ref))
+          if (in.GamesOverlap(g, g2))
+            cost -= Weights::overlap;
+      if (mv.new_ref != -1)
+        for (unsigned g2 : st.RefereeGames(mv.new_ref))
+          if (in.GamesOverlap(g, g2))
+            cost += Weights::overlap;
+    }
+  return cost;
+}
+
+// The whole group as a single cost component (with weight 1, the weights are inside)
+template <class Weights>
+class RA_Fused : public CostComponent<RA_Input,RA_Output>
+{
+public:
+  RA_Fused(const RA_Input & in, bool hard, string name) : CostComponent<RA_Input,RA_Output>(in,1,hard,name)
+  {}
+  int ComputeCost(const RA_Output& st) const override { return RA_FusedCost<Weights>(in, st); }
+  void PrintViolations(const RA_Output& st, ostream& os = cout) const override
+  { os << "Fused cost " << RA_FusedCost<Weights>(in, st) << " (use the per-component evaluator for details)" << endl; }
+};
+
+template <class Weights>
+class RA_ChangeDeltaFused
+  : public DeltaCostComponent<RA_Input,RA_Output,RA_Change>
+{
+public:
+  RA_ChangeDeltaFused(const RA_Input & in, RA_Fused<Weights>& cc, string name)
+    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,name)
+  {}
+  int ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const override
+  { return RA_FusedDeltaCost<Weights>(in, st, mv); }
+};
+
+#endif
@@ -0,0 +1,143 @@
+// File RA_Generate.cc
+// Generator of synthetic instances in the format of the Instances directory, of any size (e.g.
+// for RA_Bench). Each division plays a double round robin, one round per weekend (Friday to
+// Sunday) from 4/1/2019; team t plays at home in arena t modulo the number of arenas.
+// Referees, arenas and unavailabilities are drawn uniformly, with the ranges of the bundled
+// instances. RA_Generate.cc has its own main(), so it is linked apart from RA_Main.cc (see there)
+#include <easylocal.hh>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <random>
+#include <cstdio>
+
+using namespace std;
+using namespace EasyLocal::Core;
+
+// Date "d/m/y" that comes days after 4/1/2019
+static string Date(unsigned days)
+{
+  unsigned day = 4, month = 1, year = 2019, length;
+  day += days;
+  while (day > (length = month == 2 ? (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0) ? 29 : 28)
+                : month == 4 || month == 6 || month == 9 || month == 11 ? 30 : 31))
+    {
+      day -= length;
+      if (++month > 12)
+        {
+          month = 1;
+          year++;
+        }
+    }
+  return to_string(day) + "/" + to_string(month) + "/" + to_string(year);
+}
+
+// Time "hh:mm" of a number of minutes from midnight
+static string Time(unsigned minutes)
+{
+  char time[8];
+  snprintf(time, sizeof(time), "%u:%02u", minutes / 60, minutes % 60);
+  return time;
+}
+
+int main(int argc, const char* argv[])
+{
+  ParameterBox generate_parameters("generate", "Generator options");
+  Parameter<unsigned> divisions("divisions", "Number of divisions (default 4)", generate_parameters);
+  Parameter<unsigned> teams("teams", "Teams in each division, even (default 12)", generate_parameters);
+  Parameter<unsigned> referees("referees", "Number of referees (default 10 per division)", generate_parameters);
+  Parameter<unsigned> arenas("arenas", "Number of arenas (default one per home team)", generate_parameters);
+  Parameter<int> seed("seed", "Random seed", generate_parameters);
+  Parameter<string> output_file("output_file", "Write the instance to a file (default standard output)", generate_parameters);
+
+  CommandLineParameters::Parse(argc, argv, false, true);
+  unsigned n_divisions = divisions.IsSet() ? static_cast<unsigned>(divisions) : 4;
+  unsigned n_teams = teams.IsSet() ? static_cast<unsigned>(teams) : 12;
+  unsigned n_referees = referees.IsSet() ? static_cast<unsigned>(referees) : 10 * n_divisions;
+  unsigned n_arenas = arenas.IsSet() ? static_cast<unsigned>(arenas) : n_divisions * n_teams;
+  if (n_divisions == 0 || n_teams < 2 || n_teams % 2 != 0 || n_referees < 2 || n_arenas == 0)
+    {
+      cout << "Error: at least one division, an even number of teams (at least 2), two referees and one arena" << endl;
+      return 1;
+    }
+
+  mt19937 generator(seed.IsSet() ? static_cast<int>(seed) : random_device()());
+  auto uniform = [&generator](unsigned a, unsigned b) { return uniform_int_distribution<unsigned>(a, b)(generator); };
+  auto coordinate = [&generator]() { return uniform_real_distribution<float>(0.0f, 50.0f)(generator); };
+  unsigned rounds = 2 * (n_teams - 1), d, r, a, t, k, i, u;
+
+  ofstream file;
+  if (output_file.IsSet())
+    {
+      file.open(static_cast<string>(output_file));
+      if (!file)
+        {
+          cerr << "Cannot open output file " << static_cast<string>(output_file) << endl;
+          return 1;
+        }
+    }
+  ostream& os = output_file.IsSet() ? file : cout;
+
+  os << "Divisions = " << n_divisions << ";" << endl;
+  os << "Referees = " << n_referees << ";" << endl;
+  os << "Arenas = " << n_arenas << ";" << endl;
+  os << "Teams = " << n_divisions * n_teams << ";" << endl;
+  os << "Games = " << n_divisions * n_teams * (n_teams - 1) << ";" << endl << endl;
+
+  os << "DIVISIONS % code, min referees, max referees, level, teams" << endl;
+  for (d = 0; d < n_divisions; d++)
+    {
+      unsigned min_referees = uniform(1, 2);
+      os << "D" << d + 1 << ": " << min_referees << ", " << min_referees + uniform(0, 2) << ", "
+         << uniform(1, 4) << ", " << n_teams << endl;
+    }
+
+  os << endl << "REFEREES % code, level, coordinates, experience, incompatible referees, incompatible teams, unavailabilities" << endl;
+  for (r = 0; r < n_referees; r++)
+    {
+      os << "R" << r + 1 << ", " << uniform(2, 5) << ", (" << coordinate() << ", " << coordinate() << "), "
+         << uniform(5, 12) << ", [";
+      if (uniform(0, 9) < 3)
+        os << "R" << (r + uniform(1, n_referees - 1)) % n_referees + 1;
+      os << "], [";
+      if (uniform(0, 9) < 3)
+        os << "T" << uniform(1, n_divisions * n_teams);
+      os << "], [";
+      for (k = 0, u = uniform(0, 6); k < u; k++)
+        {
+          unsigned start = 12 * 60 + 15 * uniform(0, 36), end = min(start + 15 * uniform(8, 40), 23u * 60 + 45);
+          os << (k > 0 ? ", " : "") << Date(uniform(0, 7 * rounds)) << " " << Time(start) << "-" << Time(end);
+        }
+      os << "]" << endl;
+    }
+
+  os << endl << "ARENAS % code, coordinates" << endl;
+  for (a = 0; a < n_arenas; a++)
+    os << "A" << a + 1 << " (" << coordinate() << ", " << coordinate() << ")" << endl;
+
+  os << endl << "TEAMS % name, division" << endl;
+  for (t = 0; t < n_divisions * n_teams; t++)
+    os << "T" << t + 1 << " D" << t / n_teams + 1 << endl;
+
+  // circle method: the last team stays, the others rotate; the second half swaps home and guest
+  os << endl << "GAMES % Home team, guest team, division, date, time, arena, experience" << endl;
+  for (d = 0; d < n_divisions; d++)
+    for (k = 0; k < rounds; k++)
+      {
+        unsigned round = k % (n_teams - 1);
+        for (i = 0; i < n_teams / 2; i++)
+          {
+            unsigned home = (round + i) % (n_teams - 1),
+              guest = i == 0 ? n_teams - 1 : (round + n_teams - 1 - i) % (n_teams - 1);
+            if ((i == 0 && round % 2 == 1) != (k >= n_teams - 1))
+              swap(home, guest);
+            home += d * n_teams;
+            guest += d * n_teams;
+            os << "T" << home + 1 << " T" << guest + 1 << " D" << d + 1 << " " << Date(7 * k + uniform(0, 2))
+               << " " << Time(17 * 60 + 15 * uniform(0, 16)) << " A" << home % n_arenas + 1 << " "
+               << uniform(4, 8) << endl;
+          }
+        os << endl;
+      }
+  return 0;
+}
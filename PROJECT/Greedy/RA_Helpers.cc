@@ -1,211 +1,461 @@
-// File WL_Helpers.cc
-#include "WL_Helpers.hh"
+// File RA_Helpers.cc
+#include "RA_Helpers.hh"
+#include <algorithm>
+#include <numeric>
 
-WL_SolutionManager::WL_SolutionManager(const WL_Input & pin) 
-  : SolutionManager<WL_Input,WL_Output>(pin, "WLSolutionManager")  {} 
+RA_SolutionManager::RA_SolutionManager(const RA_Input & pin)
+  : SolutionManager<RA_Input,RA_Output>(pin, "RASolutionManager"), target_cost(0)  {}
 
-void WL_SolutionManager::RandomState(WL_Output& out) 
+void RA_SolutionManager::RandomState(RA_Output& out)
 {
-  unsigned s, w;
+  unsigned g, i, n, r;
+  vector<unsigned> referees(in.Referees());
+
   out.Reset();
-  for (s = 0; s < in.Stores(); s++)
+  iota(referees.begin(), referees.end(), 0);
+  for (g = 0; g < in.Games(); g++)
     {
-      w = Random::Uniform<int>(0, in.Warehouses() - 1);
-      out.Assign(s,w);
+      n = Random::Uniform<unsigned>(in.MinReferees(g), min(in.MaxReferees(g), in.Referees()));
+      for (i = 0; i < n; i++)
+        { // partial shuffle: the first n referees are distinct
+          r = Random::Uniform<unsigned>(i, in.Referees() - 1);
+          swap(referees[i], referees[r]);
+          out.AssignRefereetoGame(g, referees[i]);
+        }
     }
-} 
+}
 
-void WL_SolutionManager::GreedyState(WL_Output& out) 
+void RA_SolutionManager::GreedyState(RA_Output& out)
 {
-  bool found_first;
-  unsigned i, s, w, best_s, best_i, best_w;
-  double cost, best_cost, amortized_fixed_cost;
-  vector<unsigned> unserved_stores(in.Stores());
-
   out.Reset();
-  iota(unserved_stores.begin(), unserved_stores.end(),0);
+  for (unsigned g = 0; g < in.Games(); g++)
+    AddClosestReferees(out, g, in.MaxReferees(g));
+}
+
+void RA_SolutionManager::RepairState(RA_Output& out)
+{
+  for (unsigned g = 0; g < in.Games(); g++)
+    if (out.AssignedReferees(g).size() < in.MinReferees(g))
+      AddClosestReferees(out, g, in.MinReferees(g));
+}
+
+void RA_SolutionManager::AddClosestReferees(RA_Output& out, unsigned g, unsigned n)
+{
+  unsigned r;
+  vector<unsigned> referees(in.Referees());
 
-  while(unserved_stores.size() > 0)
+  // closest referees first
+  iota(referees.begin(), referees.end(), 0);
+  sort(referees.begin(), referees.end(), [this, g](unsigned r1, unsigned r2)
+       { return in.DistanceGameReferee(g, r1) < in.DistanceGameReferee(g, r2); });
+
+  for (unsigned r : referees)
+    {
+      if (out.AssignedReferees(g).size() >= n)
+        break;
+      if (out.IsAssigned(g, r) || !in.RefereeAvailable(r, g) || in.RefereeTeamIncompatible(r, g))
+        continue;
+      bool compatible = true;
+      for (unsigned g2 : out.RefereeGames(r))
+        if (in.GamesOverlap(g, g2))
+          compatible = false;
+      for (unsigned r2 : out.AssignedReferees(g))
+        if (in.RefereesIncompatible(r, r2))
+          compatible = false;
+      if (compatible)
+        out.AssignRefereetoGame(g, r);
+    }
+
+  // if the mandatory referees are not covered, take the closest ones anyway
+  for (r = 0; out.AssignedReferees(g).size() < in.MinReferees(g) && r < in.Referees(); r++)
+    if (!out.IsAssigned(g, referees[r]))
+      out.AssignRefereetoGame(g, referees[r]);
+}
+
+bool RA_SolutionManager::CheckConsistency(const RA_Output& st) const
+{
+  unsigned g, r, assignments = 0, total_games = 0;
+  int total_distance = 0;
+  long long squared_games = 0, squared_distance = 0;
+  for (g = 0; g < in.Games(); g++)
     {
-      found_first = false;
-      for (i = 0; i < unserved_stores.size(); i++)
+      const auto& referees = st.AssignedReferees(g);
+      if (referees.size() < in.MinReferees(g) || referees.size() > in.MaxReferees(g))
+        return false;
+      for (unsigned i = 0; i < referees.size(); i++)
+        for (unsigned j = i + 1; j < referees.size(); j++)
+          if (referees[i] == referees[j])
+            return false;
+      assignments += referees.size();
+    }
+  for (r = 0; r < in.Referees(); r++)
+    {
+      const auto& games = st.RefereeGames(r);
+      for (unsigned g : games)
+        if (!st.IsAssigned(g, r))
+          return false;
+      for (unsigned i = 1; i < games.size(); i++)
+        if (!in.GameBefore(games[i - 1], games[i]))
+          return false;
+      // the workload counters must match the timeline
+      int distance = 0, previous = -1;
+      vector<unsigned> level_games(st.Levels(), 0);
+      for (unsigned g : games)
         {
-          s = unserved_stores[i];
-          for (w = 0; w < in.Warehouses(); w++)
-            if (out.ResidualCapacity(w) > in.AmountOfGoods(s))
-              {
-                if (out.Load(w) == 0) 
-                  amortized_fixed_cost = in.FixedCost(w) * in.AmountOfGoods(s)/static_cast<double>(in.Capacity(w));
-                else
-                  amortized_fixed_cost = 0.0;
-                if (!found_first)
-                  {
-                    found_first = true;
-                    best_w = w;
-                    best_s = s;
-                    best_i = i;
-                    best_cost = in.SupplyCost(s,w) + amortized_fixed_cost;
-                  }
-                else
-                  {
-                    cost = in.SupplyCost(s,w) + amortized_fixed_cost;
-                    if (cost < best_cost) 
-                      {
-                        best_w = w;
-                        best_s = s;
-                        best_i = i;
-                        best_cost = cost;
-                      }
-                  }
-              }
+          if (previous != -1 && in.GameDay(previous) != in.GameDay(g))
+            {
+              distance += Leg(in, r, previous, -1);
+              previous = -1;
+            }
+          distance += Leg(in, r, previous, g);
+          previous = g;
+          level_games[in.GameLevel(g)]++;
         }
-      if (!found_first)
-        break; // no feasible assignment found
-      out.Assign(best_s,best_w);
-      unserved_stores.erase(unserved_stores.begin() + best_i);
+      distance += Leg(in, r, previous, -1);
+      if (distance != st.RefereeDistance(r))
+        return false;
+      total_games += games.size();
+      total_distance += distance;
+      squared_games += static_cast<long long>(games.size()) * games.size();
+      squared_distance += static_cast<long long>(distance) * distance;
+      for (unsigned l = 0; l < st.Levels(); l++)
+        if (level_games[l] != st.RefereeLevelGames(r, l))
+          return false;
+      assignments -= games.size();
     }
-  if (unserved_stores.size() > 0) // if there are unassigned stores, assign all of them to warehouse 0
-    for (i = 0; i < unserved_stores.size(); i++)
-      out.Assign(unserved_stores[i], 0);
+  return assignments == 0 && total_games == st.TotalGames() && total_distance == st.TotalDistance()
+    && squared_games == st.SquaredGames() && squared_distance == st.SquaredDistance();
 }
 
-bool WL_SolutionManager::CheckConsistency(const WL_Output& st) const
-{ // not necessary, as state modifications are managed by the single method Assign
-  return true;
+int RA_Overlap::ComputeCost(const RA_Output& st) const
+{
+  unsigned r, i, j, cost = 0;
+  for (r = 0; r < in.Referees(); r++)
+    {
+      const auto& games = st.RefereeGames(r);
+      for (i = 0; i < games.size(); i++)
+        for (j = i + 1; j < games.size(); j++)
+          if (in.GamesOverlap(games[i], games[j]))
+            cost++;
+    }
+  return cost;
+}
+
+void RA_Overlap::PrintViolations(const RA_Output& st, ostream& os) const
+{
+  unsigned r, i, j;
+  for (r = 0; r < in.Referees(); r++)
+    {
+      const auto& games = st.RefereeGames(r);
+      for (i = 0; i < games.size(); i++)
+        for (j = i + 1; j < games.size(); j++)
+          if (in.GamesOverlap(games[i], games[j]))
+            os << "Referee " << in.RefereeCode(r) << " cannot officiate both "
+               << in.GameHomeTeamCode(games[i]) << "-" << in.GameGuestTeamCode(games[i]) << " and "
+               << in.GameHomeTeamCode(games[j]) << "-" << in.GameGuestTeamCode(games[j]) << endl;
+    }
+}
+
+int RA_Availability::ComputeCost(const RA_Output& st) const
+{
+  unsigned g, cost = 0;
+  for (g = 0; g < in.Games(); g++)
+    for (unsigned r : st.AssignedReferees(g))
+      if (!in.RefereeAvailable(r, g))
+        cost++;
+  return cost;
+}
+
+void RA_Availability::PrintViolations(const RA_Output& st, ostream& os) const
+{
+  unsigned g;
+  for (g = 0; g < in.Games(); g++)
+    for (unsigned r : st.AssignedReferees(g))
+      if (!in.RefereeAvailable(r, g))
+        os << "Referee " << in.RefereeCode(r) << " is not available for "
+           << in.GameHomeTeamCode(g) << "-" << in.GameGuestTeamCode(g) << endl;
+}
+
+int RA_Level::ComputeCost(const RA_Output& st) const
+{
+  unsigned g;
+  int cost = 0;
+  for (g = 0; g < in.Games(); g++)
+    for (unsigned r : st.AssignedReferees(g))
+      cost += MissingLevel(in, g, r);
+  return cost;
+}
+
+void RA_Level::PrintViolations(const RA_Output& st, ostream& os) const
+{
+  unsigned g;
+  for (g = 0; g < in.Games(); g++)
+    for (unsigned r : st.AssignedReferees(g))
+      if (MissingLevel(in, g, r) > 0)
+        os << "Referee " << in.RefereeCode(r) << " (level " << in.RefereeLevel(r) << ") is below the level "
+           << in.GameLevel(g) << " of " << in.GameHomeTeamCode(g) << "-" << in.GameGuestTeamCode(g) << endl;
 }
 
-int WL_Supply::ComputeCost(const WL_Output& st) const
+int RA_Experience::ComputeCost(const RA_Output& st) const
 {
-  unsigned s, cost = 0;
-  for (s = 0; s < in.Stores(); s++)
-    cost += in.AmountOfGoods(s) * in.SupplyCost(s,st.Assignment(s));
+  unsigned g, experience;
+  int cost = 0;
+  for (g = 0; g < in.Games(); g++)
+    {
+      experience = 0;
+      for (unsigned r : st.AssignedReferees(g))
+        experience += in.RefereeExperience(r);
+      cost += MissingExperience(in, g, experience);
+    }
   return cost;
 }
 
-void WL_Supply::PrintViolations(const WL_Output& st, ostream& os) const
+void RA_Experience::PrintViolations(const RA_Output& st, ostream& os) const
 {
-  unsigned s;
-  for (s = 0; s < in.Stores(); s++)
-    os << "The cost of supplying " << in.AmountOfGoods(s) << " units from " << st.Assignment(s) 
-      << " to " << s << " is " << in.AmountOfGoods(s)*in.SupplyCost(s,st.Assignment(s)) 
-      << " (cost per unit " << in.SupplyCost(s,st.Assignment(s)) << ")" << endl;	
+  unsigned g, experience;
+  for (g = 0; g < in.Games(); g++)
+    {
+      experience = 0;
+      for (unsigned r : st.AssignedReferees(g))
+        experience += in.RefereeExperience(r);
+      if (MissingExperience(in, g, experience) > 0)
+        os << "The crew of " << in.GameHomeTeamCode(g) << "-" << in.GameGuestTeamCode(g) << " has experience "
+           << experience << " instead of " << in.GameExperience(g) << endl;
+    }
 }
 
-int WL_Opening::ComputeCost(const WL_Output& st) const
-{ 
-  unsigned w, cost = 0;
-  for (w = 0; w < in.Warehouses(); w++)
-    if (st.Load(w) > 0)
-      cost += in.FixedCost(w);
+int RA_Distance::ComputeCost(const RA_Output& st) const
+{
+  unsigned r;
+  int cost = 0, previous;
+  for (r = 0; r < in.Referees(); r++)
+    {
+      previous = -1;
+      for (unsigned g : st.RefereeGames(r))
+        {
+          if (previous != -1 && in.GameDay(previous) != in.GameDay(g))
+            { // back home at the end of the day
+              cost += Leg(in, r, previous, -1);
+              previous = -1;
+            }
+          cost += Leg(in, r, previous, g);
+          previous = g;
+        }
+      cost += Leg(in, r, previous, -1);
+    }
   return cost;
 }
 
-void WL_Opening::PrintViolations(const WL_Output& st, ostream& os) const
+void RA_Distance::PrintViolations(const RA_Output& st, ostream& os) const
 {
-  unsigned w;
-  for (w = 0; w < in.Warehouses(); w++)
-    if (st.Load(w) > 0)
-      os << "The cost of opening warehouse " << w << " is " << in.FixedCost(w) << endl;
+  unsigned r;
+  int previous;
+  for (r = 0; r < in.Referees(); r++)
+    {
+      previous = -1;
+      for (unsigned g : st.RefereeGames(r))
+        {
+          if (previous != -1 && in.GameDay(previous) != in.GameDay(g))
+            {
+              os << "Referee " << in.RefereeCode(r) << " travels " << Leg(in, r, previous, -1) << " back home" << endl;
+              previous = -1;
+            }
+          os << "Referee " << in.RefereeCode(r) << " travels " << Leg(in, r, previous, g) << " to "
+             << in.GameHomeTeamCode(g) << "-" << in.GameGuestTeamCode(g) << endl;
+          previous = g;
+        }
+      if (previous != -1)
+        os << "Referee " << in.RefereeCode(r) << " travels " << Leg(in, r, previous, -1) << " back home" << endl;
+    }
 }
 
-int WL_Capacity::ComputeCost(const WL_Output& st) const
-{ 
-  unsigned w, cost = 0;
-  for (w = 0; w < in.Warehouses(); w++)
-    if (st.Load(w) > in.Capacity(w))
-      cost += st.Load(w) - in.Capacity(w);
+int RA_Optional::ComputeCost(const RA_Output& st) const
+{
+  unsigned g;
+  int cost = 0;
+  for (g = 0; g < in.Games(); g++)
+    cost += in.MaxReferees(g) - st.AssignedReferees(g).size();
+  return cost;
+}
+
+void RA_Optional::PrintViolations(const RA_Output& st, ostream& os) const
+{
+  unsigned g;
+  for (g = 0; g < in.Games(); g++)
+    if (st.AssignedReferees(g).size() < in.MaxReferees(g))
+      os << "Game " << in.GameHomeTeamCode(g) << "-" << in.GameGuestTeamCode(g) << " misses "
+         << in.MaxReferees(g) - st.AssignedReferees(g).size() << " optional referee(s)" << endl;
+}
+
+int RA_RefereeIncompatibility::ComputeCost(const RA_Output& st) const
+{
+  unsigned g, i, j, cost = 0;
+  for (g = 0; g < in.Games(); g++)
+    {
+      const auto& referees = st.AssignedReferees(g);
+      for (i = 0; i < referees.size(); i++)
+        for (j = i + 1; j < referees.size(); j++)
+          if (in.RefereesIncompatible(referees[i], referees[j]))
+            cost++;
+    }
+  return cost;
+}
+
+void RA_RefereeIncompatibility::PrintViolations(const RA_Output& st, ostream& os) const
+{
+  unsigned g, i, j;
+  for (g = 0; g < in.Games(); g++)
+    {
+      const auto& referees = st.AssignedReferees(g);
+      for (i = 0; i < referees.size(); i++)
+        for (j = i + 1; j < referees.size(); j++)
+          if (in.RefereesIncompatible(referees[i], referees[j]))
+            os << "Referees " << in.RefereeCode(referees[i]) << " and " << in.RefereeCode(referees[j])
+               << " are incompatible in " << in.GameHomeTeamCode(g) << "-" << in.GameGuestTeamCode(g) << endl;
+    }
+}
+
+int RA_TeamIncompatibility::ComputeCost(const RA_Output& st) const
+{
+  unsigned g, cost = 0;
+  for (g = 0; g < in.Games(); g++)
+    for (unsigned r : st.AssignedReferees(g))
+      if (in.RefereeTeamIncompatible(r, g))
+        cost++;
   return cost;
 }
 
-void WL_Capacity::PrintViolations(const WL_Output& st, ostream& os) const
+void RA_TeamIncompatibility::PrintViolations(const RA_Output& st, ostream& os) const
 {
-  unsigned w;
-  for (w = 0; w < in.Warehouses(); w++)
-    if (st.Load(w) > in.Capacity(w))
-      os << "Warehouse " << w << " is overloaded by " << st.Load(w) - in.Capacity(w) << endl;
+  unsigned g;
+  for (g = 0; g < in.Games(); g++)
+    for (unsigned r : st.AssignedReferees(g))
+      if (in.RefereeTeamIncompatible(r, g))
+        os << "Referee " << in.RefereeCode(r) << " is incompatible with a team of "
+           << in.GameHomeTeamCode(g) << "-" << in.GameGuestTeamCode(g) << endl;
+}
+
+int RA_Balance::Cost(long long games, long long squared_games, long long distance, long long squared_distance) const
+{
+  long long n = in.Referees();
+  if (n == 0)
+    return 0;
+  return static_cast<int>((n * squared_games - games * games) / n
+                          + (n * squared_distance - distance * distance) / (n * DISTANCE_UNIT * DISTANCE_UNIT));
+}
+
+int RA_Balance::ComputeCost(const RA_Output& st) const
+{
+  return Cost(st.TotalGames(), st.SquaredGames(), st.TotalDistance(), st.SquaredDistance());
+}
+
+void RA_Balance::PrintViolations(const RA_Output& st, ostream& os) const
+{
+  if (in.Referees() == 0)
+    return;
+  double average_games = static_cast<double>(st.TotalGames()) / in.Referees(),
+    average_distance = static_cast<double>(st.TotalDistance()) / in.Referees();
+  for (unsigned r = 0; r < in.Referees(); r++)
+    {
+      os << "Referee " << in.RefereeCode(r) << " officiates " << st.RefereeGameCount(r) << " games (average "
+         << average_games << "), travels " << st.RefereeDistance(r) << " (average " << average_distance
+         << "), games per level:";
+      for (unsigned l = 0; l < st.Levels(); l++)
+        if (st.RefereeLevelGames(r, l) > 0)
+          os << " " << l << ":" << st.RefereeLevelGames(r, l);
+      os << endl;
+    }
 }
 
 /*****************************************************************************
-  * WL_Change Neighborhood Methods
+  * RA_Change Neighborhood Methods
   *****************************************************************************/
-WL_Change::WL_Change()
+RA_Change::RA_Change()
 {
-  store = -1;
-  old_w = -1;
-  new_w = -1;
+  game = -1;
+  old_ref = -1;
+  new_ref = -1;
 }
 
-bool operator==(const WL_Change& mv1, const WL_Change& mv2)
+bool operator==(const RA_Change& mv1, const RA_Change& mv2)
 {
-  return mv1.store == mv2.store && mv1.new_w == mv2.new_w;
+  return mv1.game == mv2.game && mv1.old_ref == mv2.old_ref && mv1.new_ref == mv2.new_ref;
 }
 
-bool operator!=(const WL_Change& mv1, const WL_Change& mv2)
+bool operator!=(const RA_Change& mv1, const RA_Change& mv2)
 {
-  return mv1.store != mv2.store || mv1.new_w != mv2.new_w;
+  return mv1.game != mv2.game || mv1.old_ref != mv2.old_ref || mv1.new_ref != mv2.new_ref;
 }
 
-bool operator<(const WL_Change& mv1, const WL_Change& mv2)
+bool operator<(const RA_Change& mv1, const RA_Change& mv2)
 {
-  return (mv1.store < mv2.store)
-  || (mv1.store == mv2.store && mv1.new_w < mv2.new_w);
+  return (mv1.game < mv2.game)
+  || (mv1.game == mv2.game && mv1.old_ref < mv2.old_ref)
+  || (mv1.game == mv2.game && mv1.old_ref == mv2.old_ref && mv1.new_ref < mv2.new_ref);
 }
 
-istream& operator>>(istream& is, WL_Change& mv)
+istream& operator>>(istream& is, RA_Change& mv)
 {
   char ch;
-  is >> mv.store >> ch >> mv.old_w >> ch >> ch >> mv.new_w;
+  is >> mv.game >> ch >> mv.old_ref >> ch >> ch >> mv.new_ref;
   return is;
 }
 
-ostream& operator<<(ostream& os, const WL_Change& mv)
+ostream& operator<<(ostream& os, const RA_Change& mv)
 {
-  os << mv.store << ':' << mv.old_w << "->" << mv.new_w;
+  os << mv.game << ':' << mv.old_ref << "->" << mv.new_ref;
   return os;
 }
 
-void WL_ChangeNeighborhoodExplorer::RandomMove(const WL_Output& st, WL_Change& mv) const
-{ 
-  mv.store = Random::Uniform<unsigned>(0, in.Stores() - 1);
-  mv.old_w = st.Assignment(mv.store);
-  
-  do{
-    mv.new_w = Random::Uniform<unsigned>(0, in.Warehouses() - 1);
-  }while (mv.new_w == mv.old_w); // assicura che le due warehouse siano diverse
-} 
-
-bool WL_ChangeNeighborhoodExplorer::FeasibleMove(const WL_Output& st, const WL_Change& mv) const
-{
-  // controlla che il magazzino nuovo sia diverso da quello vecchio e che siano un magazzino e uno store validi
-  return (mv.store < in.Stores() && mv.new_w < in.Warehouses() && mv.old_w != mv.new_w);
-} 
-
-void WL_ChangeNeighborhoodExplorer::MakeMove(WL_Output& st, const WL_Change& mv) const
-{
-  // assegna il nuovo magazzino allo store
-  st.Assign(mv.store, mv.new_w);
-}  
-
-void WL_ChangeNeighborhoodExplorer::FirstMove(const WL_Output& st, WL_Change& mv) const
-{
-  mv.store = 0; // inizia col primo store
-  mv.old_w = st.Assignment(mv.store);
-    
-  // trova la prima warehouse disponibile
-  mv.new_w = 0;
-  
-  // skippa il magazzino corrente se uguale al nuovo
-  while (mv.new_w == mv.old_w){
-    mv.new_w++;
-  }
-  
-  // se abbiamo superato il numero di magazzini, passiamo al prossimo store
-  if (mv.new_w >= in.Warehouses()){
+void RA_ChangeNeighborhoodExplorer::RandomMove(const RA_Output& st, RA_Change& mv) const
+{
+  do
+    {
+      mv.game = Random::Uniform<int>(0, in.Games() - 1);
+      const auto& referees = st.AssignedReferees(mv.game);
+      // the slot after the last referee is the empty one (used only if an optional slot is free)
+      unsigned slot = Random::Uniform<unsigned>(0, referees.size() < in.MaxReferees(mv.game) ? referees.size() : referees.size() - 1);
+      mv.old_ref = slot < referees.size() ? referees[slot] : -1;
+      mv.new_ref = Random::Uniform<int>(-1, in.Referees() - 1);
+    }
+  while (!FeasibleMove(st, mv));
+}
+
+bool RA_ChangeNeighborhoodExplorer::FeasibleMove(const RA_Output& st, const RA_Change& mv) const
+{
+  const auto& referees = st.AssignedReferees(mv.game);
+  if (mv.old_ref == mv.new_ref)
+    return false;
+  if (mv.old_ref == -1 && referees.size() >= in.MaxReferees(mv.game))
+    return false; // no optional slot free
+  if (mv.new_ref == -1 && referees.size() <= in.MinReferees(mv.game))
+    return false; // the mandatory referees cannot be removed
+  if (mv.old_ref != -1 && !st.IsAssigned(mv.game, mv.old_ref))
+    return false;
+  return mv.new_ref == -1 || !st.IsAssigned(mv.game, mv.new_ref);
+}
+
+void RA_ChangeNeighborhoodExplorer::MakeMove(RA_Output& st, const RA_Change& mv) const
+{
+  if (mv.old_ref == -1)
+    st.AssignRefereetoGame(mv.game, mv.new_ref);
+  else if (mv.new_ref == -1)
+    st.RemoveRefereefromGame(mv.game, mv.old_ref);
+  else
+    st.ChangeReferee(mv.game, mv.old_ref, mv.new_ref);
+}
+
+void RA_ChangeNeighborhoodExplorer::FirstMove(const RA_Output& st, RA_Change& mv) const
+{
+  mv.game = 0; // start from the first slot of the first game
+  mv.old_ref = st.AssignedReferees(mv.game).empty() ? -1 : st.AssignedReferees(mv.game)[0];
+  mv.new_ref = -1;
+
+  if (!FeasibleMove(st, mv))
     NextMove(st, mv);
-  }
 }
 
-bool WL_ChangeNeighborhoodExplorer::NextMove(const WL_Output& st, WL_Change& mv) const
+bool RA_ChangeNeighborhoodExplorer::NextMove(const RA_Output& st, RA_Change& mv) const
 {
   do
     if (!AnyNextMove(st,mv))
@@ -214,87 +464,169 @@ bool WL_ChangeNeighborhoodExplorer::NextMove(const WL_Output& st, WL_Change& mv)
   return true;
 }
 
-bool WL_ChangeNeighborhoodExplorer::AnyNextMove(const WL_Output& st, WL_Change& mv) const
+// Enumeration order: game, then slot (assigned referees, then the empty slot), then new referee
+bool RA_ChangeNeighborhoodExplorer::AnyNextMove(const RA_Output& st, RA_Change& mv) const
 {
-  mv.new_w++;
-  
-  // skippa il magazzino corrente se uguale al nuovo
-  if (mv.new_w == mv.old_w)
-    mv.new_w++;
-  
-  if(mv.new_w >= in.Warehouses())
-  {
-    mv.store++;
+  mv.new_ref++;
+  if (mv.new_ref < static_cast<int>(in.Referees()))
+    return true;
 
-    if(mv.store >= in.Stores())
-      return false;
-
-    mv.old_w = st.Assignment(mv.store);
-    mv.new_w = 0;
+  const auto& referees = st.AssignedReferees(mv.game);
+  mv.new_ref = -1;
+  if (mv.old_ref != -1)
+    {
+      unsigned slot = find(referees.begin(), referees.end(), mv.old_ref) - referees.begin() + 1;
+      if (slot < referees.size())
+        {
+          mv.old_ref = referees[slot];
+          return true;
+        }
+      if (referees.size() < in.MaxReferees(mv.game))
+        {
+          mv.old_ref = -1;
+          return true;
+        }
+    }
 
-    if(mv.old_w == mv.new_w) // skippiamo il magazzino corrente se uguale al nuovo
-      mv.new_w++; 
-    
-    if(mv.new_w >= in.Warehouses())
-      return false; // assicura che non si superi il numero di magazzini
-  }
+  mv.game++;
+  if (mv.game >= static_cast<int>(in.Games()))
+    return false;
+  mv.old_ref = st.AssignedReferees(mv.game).empty() ? -1 : st.AssignedReferees(mv.game)[0];
   return true;
 }
 
-int WL_ChangeDeltaSupply::ComputeDeltaCost(const WL_Output& st, const WL_Change& mv) const
+int RA_ChangeDeltaOverlap::ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const
 {
   int cost = 0;
 
-  if (mv.old_w != -1) // se lo store era assegnato a un magazzino rimuvi il costo della fornitura dal vecchio magazzino
-    cost -= in.AmountOfGoods(mv.store) * in.SupplyCost(mv.store, mv.old_w);
-  
-  cost += in.AmountOfGoods(mv.store) * in.SupplyCost(mv.store, mv.new_w);
-  // aggiungi il costo della fornitura al nuovo magazzino
+  if (mv.old_ref != -1) // remove the overlaps of the old referee with this game
+    for (unsigned g2 : st.RefereeGames(mv.old_ref))
+      if (in.GamesOverlap(mv.game, g2))
+        cost--;
+
+  if (mv.new_ref != -1) // add the overlaps of the new referee with this game
+    for (unsigned g2 : st.RefereeGames(mv.new_ref))
+      if (in.GamesOverlap(mv.game, g2))
+        cost++;
 
   return cost;
 }
 
-int WL_ChangeDeltaOpening::ComputeDeltaCost(const WL_Output& st, const WL_Change& mv) const
+int RA_ChangeDeltaAvailability::ComputeDeltaCost(const RA_Output&, const RA_Change& mv) const
 {
   int cost = 0;
-  
-  if (mv.old_w != -1 && st.Load(mv.old_w) == in.AmountOfGoods(mv.store)) 
-    // se lo store era l'unico assegnato al vecchio magazzino
-    cost -= in.FixedCost(mv.old_w); // rimuovi il costo fisso del vecchio magazzino
-  
-  if (st.Load(mv.new_w) == 0) 
-    // se il nuovo magazzino era chiuso
-    cost += in.FixedCost(mv.new_w); // aggiungi il costo fisso del nuovo magazzino
+
+  if (mv.old_ref != -1 && !in.RefereeAvailable(mv.old_ref, mv.game))
+    cost--;
+  if (mv.new_ref != -1 && !in.RefereeAvailable(mv.new_ref, mv.game))
+    cost++;
 
   return cost;
 }
 
-int WL_ChangeDeltaCapacity::ComputeDeltaCost(const WL_Output& st, const WL_Change& mv) const
+int RA_ChangeDeltaLevel::ComputeDeltaCost(const RA_Output&, const RA_Change& mv) const
 {
   int cost = 0;
 
-  // Gestione del vecchio magazzino
-  if (mv.old_w != -1) 
-  {
-    // Calcola la violazione prima della mossa per il vecchio magazzino
-    if (st.Load(mv.old_w) > in.Capacity(mv.old_w))
-      cost -= st.Load(mv.old_w) - in.Capacity(mv.old_w);
-    
-    // Calcola la violazione dopo la mossa per il vecchio magazzino
-    unsigned new_load_old = st.Load(mv.old_w) - in.AmountOfGoods(mv.store);
-    if (new_load_old > in.Capacity(mv.old_w))
-      cost += new_load_old - in.Capacity(mv.old_w);
-  }
-
-  // Gestione del nuovo magazzino
-  // Calcola la violazione prima della mossa per il nuovo magazzino
-  if (st.Load(mv.new_w) > in.Capacity(mv.new_w))
-    cost -= st.Load(mv.new_w) - in.Capacity(mv.new_w);
-  
-  // Calcola la violazione dopo la mossa per il nuovo magazzino
-  unsigned new_load_new = st.Load(mv.new_w) + in.AmountOfGoods(mv.store);
-  if (new_load_new > in.Capacity(mv.new_w))
-    cost += new_load_new - in.Capacity(mv.new_w);
+  if (mv.old_ref != -1)
+    cost -= MissingLevel(in, mv.game, mv.old_ref);
+  if (mv.new_ref != -1)
+    cost += MissingLevel(in, mv.game, mv.new_ref);
 
   return cost;
-}
\ No newline at end of file
+}
+
+int RA_ChangeDeltaExperience::ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const
+{
+  unsigned experience = 0, new_experience;
+
+  for (unsigned r : st.AssignedReferees(mv.game))
+    experience += in.RefereeExperience(r);
+
+  new_experience = experience;
+  if (mv.old_ref != -1)
+    new_experience -= in.RefereeExperience(mv.old_ref);
+  if (mv.new_ref != -1)
+    new_experience += in.RefereeExperience(mv.new_ref);
+
+  return MissingExperience(in, mv.game, new_experience) - MissingExperience(in, mv.game, experience);
+}
+
+int RA_ChangeDeltaDistance::ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const
+{
+  int cost = 0;
+
+  if (mv.old_ref != -1)
+    cost -= st.TourDelta(mv.old_ref, mv.game);
+  if (mv.new_ref != -1)
+    cost += st.TourDelta(mv.new_ref, mv.game);
+
+  return cost;
+}
+
+int RA_ChangeDeltaOptional::ComputeDeltaCost(const RA_Output&, const RA_Change& mv) const
+{
+  if (mv.old_ref == -1) // an optional referee is added
+    return -1;
+  if (mv.new_ref == -1) // an optional referee is removed
+    return 1;
+  return 0;
+}
+
+int RA_ChangeDeltaRefereeIncompatibility::ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const
+{
+  int cost = 0;
+
+  for (unsigned r : st.AssignedReferees(mv.game))
+    {
+      if (static_cast<int>(r) == mv.old_ref)
+        continue;
+      if (mv.old_ref != -1 && in.RefereesIncompatible(mv.old_ref, r))
+        cost--;
+      if (mv.new_ref != -1 && in.RefereesIncompatible(mv.new_ref, r))
+        cost++;
+    }
+
+  return cost;
+}
+
+int RA_ChangeDeltaTeamIncompatibility::ComputeDeltaCost(const RA_Output&, const RA_Change& mv) const
+{
+  int cost = 0;
+
+  if (mv.old_ref != -1 && in.RefereeTeamIncompatible(mv.old_ref, mv.game))
+    cost--;
+  if (mv.new_ref != -1 && in.RefereeTeamIncompatible(mv.new_ref, mv.game))
+    cost++;
+
+  return cost;
+}
+
+int RA_ChangeDeltaBalance::ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const
+{
+  long long games = st.TotalGames(), squared_games = st.SquaredGames(),
+    distance = st.TotalDistance(), squared_distance = st.SquaredDistance(), count, tour, delta;
+
+  if (mv.old_ref != -1)
+    {
+      count = st.RefereeGameCount(mv.old_ref);
+      tour = st.RefereeDistance(mv.old_ref);
+      delta = st.TourDelta(mv.old_ref, mv.game);
+      games--;
+      squared_games -= 2 * count - 1;
+      distance -= delta;
+      squared_distance += (delta - 2 * tour) * delta;
+    }
+  if (mv.new_ref != -1)
+    {
+      count = st.RefereeGameCount(mv.new_ref);
+      tour = st.RefereeDistance(mv.new_ref);
+      delta = st.TourDelta(mv.new_ref, mv.game);
+      games++;
+      squared_games += 2 * count + 1;
+      distance += delta;
+      squared_distance += (2 * tour + delta) * delta;
+    }
+
+  return balance.Cost(games, squared_games, distance, squared_distance) - balance.ComputeCost(st);
+}
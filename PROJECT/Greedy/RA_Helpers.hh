@@ -4,9 +4,12 @@
 
 #include "RA_Data.hh"
 #include <easylocal.hh>
+#include <type_traits>
 
 using namespace EasyLocal::Core;
 
+// A move changes one slot of the crew of a game: old_ref == -1 adds a referee
+// in an empty optional slot, new_ref == -1 removes an optional referee
 class RA_Change
 {
   friend bool operator==(const RA_Change& m1, const RA_Change& m2);
@@ -15,99 +18,262 @@ class RA_Change
   friend ostream& operator<<(ostream& os, const RA_Change& c);
   friend istream& operator>>(istream& is, RA_Change& c);
  public:
-  string game, old_ref, new_ref;
+  int game, old_ref, new_ref;
   RA_Change();
 };
 
+// moves are copied by value by the runners, and must never allocate
+static_assert(is_trivially_copyable<RA_Change>::value, "RA_Change must be trivially copyable");
+
+// Experience missing in the crew of game g, given the total experience of the crew
+inline int MissingExperience(const RA_Input& in, unsigned g, unsigned experience)
+{
+  return experience < in.GameExperience(g) ? in.GameExperience(g) - experience : 0;
+}
+
+// Levels missing to referee r for the division of game g
+inline int MissingLevel(const RA_Input& in, unsigned g, unsigned r)
+{
+  return in.RefereeLevel(r) < in.GameLevel(g) ? in.GameLevel(g) - in.RefereeLevel(r) : 0;
+}
+
 /***************************************************************************
- * State Manager 
+ * State Manager
  ***************************************************************************/
 
-class RA_SolutionManager : public SolutionManager<RA_Input,RA_Output> 
+class RA_SolutionManager : public SolutionManager<RA_Input,RA_Output>
 {
 public:
   RA_SolutionManager(const RA_Input &);
-  void RandomState(RA_Output& out) override;   
-  void GreedyState(RA_Output& out) override;   
-  void DumpState(const ra_Output& out, ostream& os) const override { out.Dump(os); }   
+  void RandomState(RA_Output& out) override;
+  void GreedyState(RA_Output& out) override;
+  void DumpState(const RA_Output& out, ostream& os) const override { out.Dump(os); }
   bool CheckConsistency(const RA_Output& st) const override;
+  // completes the crews below the minimum size (e.g. of a solution of a modified instance)
+  void RepairState(RA_Output& out);
+  // the runners stop as soon as the cost is within the target (e.g. close enough to a lower bound)
+  void SetTargetCost(int cost) { target_cost = cost; }
+  bool LowerBoundReached(const int& fvalue) const override { return fvalue <= target_cost; }
 protected:
-}; 
+  // adds the closest compatible referees to game g, up to n (and at least up to the minimum)
+  void AddClosestReferees(RA_Output& out, unsigned g, unsigned n);
+  int target_cost;
+};
+
+/***************************************************************************
+ * Cost Components (hard)
+ ***************************************************************************/
+
+// FeasibleTravelDistance: a referee cannot officiate two overlapping games (travel time included)
+class RA_Overlap : public CostComponent<RA_Input,RA_Output>
+{
+public:
+  RA_Overlap(const RA_Input & in, int w, bool hard) : CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_Overlap")
+  {}
+  int ComputeCost(const RA_Output& st) const override;
+  void PrintViolations(const RA_Output& st, ostream& os = cout) const override;
+};
+
+// RefereeAvailability: a referee cannot be assigned to a game when unavailable
+class RA_Availability : public CostComponent<RA_Input,RA_Output>
+{
+public:
+  RA_Availability(const RA_Input & in, int w, bool hard) : CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_Availability")
+  {}
+  int ComputeCost(const RA_Output& st) const override;
+  void PrintViolations(const RA_Output& st, ostream& os = cout) const override;
+};
+
+/***************************************************************************
+ * Cost Components (soft)
+ ***************************************************************************/
+
+// RefereeLevel: one unit for each level of the referee below the level of the division
+class RA_Level : public CostComponent<RA_Input,RA_Output>
+{
+public:
+  RA_Level(const RA_Input & in, int w, bool hard) : CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_Level")
+  {}
+  int ComputeCost(const RA_Output& st) const override;
+  void PrintViolations(const RA_Output& st, ostream& os = cout) const override;
+};
+
+// LackOfExperience: one unit for each point of experience missing in the crew of a game
+class RA_Experience : public CostComponent<RA_Input,RA_Output>
+{
+public:
+  RA_Experience(const RA_Input & in, int w, bool hard) : CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_Experience")
+  {}
+  int ComputeCost(const RA_Output& st) const override;
+  void PrintViolations(const RA_Output& st, ostream& os = cout) const override;
+};
+
+// TotalDistance: each day, a referee travels home -> arena -> ... -> arena -> home, visiting
+// the arenas in time order (the transfer time between arenas is checked by RA_Overlap)
+class RA_Distance : public CostComponent<RA_Input,RA_Output>
+{
+public:
+  RA_Distance(const RA_Input & in, int w, bool hard) : CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_Distance")
+  {}
+  int ComputeCost(const RA_Output& st) const override;
+  void PrintViolations(const RA_Output& st, ostream& os = cout) const override;
+};
+
+// OptionalReferee: one unit for each optional referee not assigned
+class RA_Optional : public CostComponent<RA_Input,RA_Output>
+{
+public:
+  RA_Optional(const RA_Input & in, int w, bool hard) : CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_Optional")
+  {}
+  int ComputeCost(const RA_Output& st) const override;
+  void PrintViolations(const RA_Output& st, ostream& os = cout) const override;
+};
 
-class RA_Supply : public CostComponent<RA_Input,RA_Output> 
+// RefereeIncompatibility: one unit for each pair of incompatible referees in the same game
+class RA_RefereeIncompatibility : public CostComponent<RA_Input,RA_Output>
 {
 public:
-  RA_Supply(const RA_Input & in, int w, bool hard) :    CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_Supply") 
+  RA_RefereeIncompatibility(const RA_Input & in, int w, bool hard) : CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_RefereeIncompatibility")
   {}
   int ComputeCost(const RA_Output& st) const override;
   void PrintViolations(const RA_Output& st, ostream& os = cout) const override;
 };
 
-class  RA_Opening: public CostComponent<RA_Input,RA_Output> 
+// TeamIncompatibility: one unit for each referee assigned to a game of an incompatible team
+class RA_TeamIncompatibility : public CostComponent<RA_Input,RA_Output>
 {
 public:
-  RA_Opening(const RA_Input & in, int w, bool hard) : CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_Opening") 
+  RA_TeamIncompatibility(const RA_Input & in, int w, bool hard) : CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_TeamIncompatibility")
   {}
   int ComputeCost(const RA_Output& st) const override;
   void PrintViolations(const RA_Output& st, ostream& os = cout) const override;
 };
 
-class  RA_Capacity: public CostComponent<RA_Input,RA_Output> 
+// Balance (optional): the workload of the referees should be even. The cost is the sum of the
+// squared deviations from the mean (n times the variance) of the games of the referees, plus
+// the same for their tour distances in units of DISTANCE_UNIT km. Both are computed from the
+// sums over the referees kept by RA_Output, as (n Sum(x^2) - Sum(x)^2) / n
+class RA_Balance : public CostComponent<RA_Input,RA_Output>
 {
 public:
-  RA_Capacity(const RA_Input & in, int w, bool hard) : CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_Capacity") 
+  RA_Balance(const RA_Input & in, int w, bool hard) : CostComponent<RA_Input,RA_Output>(in,w,hard,"RA_Balance")
   {}
   int ComputeCost(const RA_Output& st) const override;
   void PrintViolations(const RA_Output& st, ostream& os = cout) const override;
+  int Cost(long long games, long long squared_games, long long distance, long long squared_distance) const;
+  static const int DISTANCE_UNIT = 10;
 };
 
 /***************************************************************************
  * RA_Change Neighborhood Explorer:
  ***************************************************************************/
 
-class RA_ChangeDeltaSupply
+class RA_ChangeDeltaOverlap
+  : public DeltaCostComponent<RA_Input,RA_Output,RA_Change>
+{
+public:
+  RA_ChangeDeltaOverlap(const RA_Input & in, RA_Overlap& cc)
+    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaOverlap")
+  {}
+  int ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const override;
+};
+
+class RA_ChangeDeltaAvailability
+  : public DeltaCostComponent<RA_Input,RA_Output,RA_Change>
+{
+public:
+  RA_ChangeDeltaAvailability(const RA_Input & in, RA_Availability& cc)
+    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaAvailability")
+  {}
+  int ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const override;
+};
+
+class RA_ChangeDeltaLevel
+  : public DeltaCostComponent<RA_Input,RA_Output,RA_Change>
+{
+public:
+  RA_ChangeDeltaLevel(const RA_Input & in, RA_Level& cc)
+    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaLevel")
+  {}
+  int ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const override;
+};
+
+class RA_ChangeDeltaExperience
+  : public DeltaCostComponent<RA_Input,RA_Output,RA_Change>
+{
+public:
+  RA_ChangeDeltaExperience(const RA_Input & in, RA_Experience& cc)
+    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaExperience")
+  {}
+  int ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const override;
+};
+
+class RA_ChangeDeltaDistance
+  : public DeltaCostComponent<RA_Input,RA_Output,RA_Change>
+{
+public:
+  RA_ChangeDeltaDistance(const RA_Input & in, RA_Distance& cc)
+    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaDistance")
+  {}
+  int ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const override;
+};
+
+class RA_ChangeDeltaOptional
+  : public DeltaCostComponent<RA_Input,RA_Output,RA_Change>
+{
+public:
+  RA_ChangeDeltaOptional(const RA_Input & in, RA_Optional& cc)
+    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaOptional")
+  {}
+  int ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const override;
+};
+
+class RA_ChangeDeltaRefereeIncompatibility
   : public DeltaCostComponent<RA_Input,RA_Output,RA_Change>
 {
 public:
-  RA_ChangeDeltaSupply(const RA_Input & in, RA_Supply& cc) 
-    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaSupply") 
+  RA_ChangeDeltaRefereeIncompatibility(const RA_Input & in, RA_RefereeIncompatibility& cc)
+    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaRefereeIncompatibility")
   {}
   int ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const override;
 };
 
-class RA_ChangeDeltaOpening
+class RA_ChangeDeltaTeamIncompatibility
   : public DeltaCostComponent<RA_Input,RA_Output,RA_Change>
 {
 public:
-  RA_ChangeDeltaOpening(const RA_Input & in, RA_Opening& cc) 
-    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaOpening") 
+  RA_ChangeDeltaTeamIncompatibility(const RA_Input & in, RA_TeamIncompatibility& cc)
+    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaTeamIncompatibility")
   {}
   int ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const override;
 };
 
-class RA_ChangeDeltaCapacity
+// Only the sums change, by the workloads of the two referees (no scan of the solution)
+class RA_ChangeDeltaBalance
   : public DeltaCostComponent<RA_Input,RA_Output,RA_Change>
 {
 public:
-  RA_ChangeDeltaCapacity(const RA_Input & in, RA_Capacity& cc) 
-    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaCapacity") 
+  RA_ChangeDeltaBalance(const RA_Input & in, RA_Balance& cc)
+    : DeltaCostComponent<RA_Input,RA_Output,RA_Change>(in,cc,"RA_ChangeDeltaBalance"), balance(cc)
   {}
   int ComputeDeltaCost(const RA_Output& st, const RA_Change& mv) const override;
+private:
+  const RA_Balance& balance;
 };
 
 class RA_ChangeNeighborhoodExplorer
-  : public NeighborhoodExplorer<RA_Input,RA_Output,RA_Change> 
+  : public NeighborhoodExplorer<RA_Input,RA_Output,RA_Change>
 {
 public:
-  RA_ChangeNeighborhoodExplorer(const RA_Input & pin, SolutionManager<RA_Input,RA_Output>& psm)  
-    : NeighborhoodExplorer<RA_Input,RA_Output,RA_Change>(pin, psm, "RA_ChangeNeighborhoodExplorer") {} 
-  void RandomMove(const RA_Output&, RA_Change&) const override;          
-  bool FeasibleMove(const RA_Output&, const RA_Change&) const override;  
-  void MakeMove(RA_Output&, const RA_Change&) const override;             
-  void FirstMove(const RA_Output&, RA_Change&) const override;  
-  bool NextMove(const RA_Output&, RA_Change&) const override;   
+  RA_ChangeNeighborhoodExplorer(const RA_Input & pin, SolutionManager<RA_Input,RA_Output>& psm)
+    : NeighborhoodExplorer<RA_Input,RA_Output,RA_Change>(pin, psm, "RA_ChangeNeighborhoodExplorer") {}
+  void RandomMove(const RA_Output&, RA_Change&) const override;
+  bool FeasibleMove(const RA_Output&, const RA_Change&) const override;
+  void MakeMove(RA_Output&, const RA_Change&) const override;
+  void FirstMove(const RA_Output&, RA_Change&) const override;
+  bool NextMove(const RA_Output&, RA_Change&) const override;
 protected:
-  bool AnyNextMove(const RA_Output&, RA_Change&) const;   
+  bool AnyNextMove(const RA_Output&, RA_Change&) const;
 };
 
 #endif
@@ -0,0 +1,245 @@
+// File RA_LowerBound.cc
+#include "RA_LowerBound.hh"
+#include "RA_Solver.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+RA_LowerBound::RA_LowerBound(const RA_Input& my_in)
+  : in(my_in), cost(in.Games(), vector<double>(in.Referees())), gamePairs(in.Games()),
+    crews(in.Games()), values(in.Games())
+{
+  unsigned g, g2, r;
+  vector<unsigned> games(in.Games());
+
+  // games grouped by day
+  for (g = 0; g < in.Games(); g++)
+    games[g] = g;
+  sort(games.begin(), games.end(), [this](unsigned g1, unsigned g2) { return in.GameBefore(g1, g2); });
+  for (g = 0; g < in.Games(); g++)
+    {
+      if (g == 0 || in.GameDay(games[g]) != in.GameDay(games[g - 1]))
+        days.push_back(vector<unsigned>());
+      days.back().push_back(games[g]);
+    }
+
+  // The daily tour of a referee is split among its games: each game gets its legs from and to
+  // home, and half of its legs from and to the other games. A leg into game g is then at least
+  // the leg from home, or half of the shortest leg from a game of the same day that does not
+  // overlap with g (legs are rounded one by one, see Leg), and so is the leg out of g
+  for (const auto& day : days)
+    for (unsigned g : day)
+      {
+        int shortest = numeric_limits<int>::max(); // shortest leg from/to another game
+        for (unsigned g2 : day)
+          if (g2 != g && !in.GamesOverlap(g, g2))
+            shortest = min(shortest, Leg(in, 0, g, g2));
+        for (r = 0; r < in.Referees(); r++)
+          {
+            if (!in.RefereeAvailable(r, g))
+              {
+                cost[g][r] = -1;
+                continue;
+              }
+            double share = min(2 * Leg(in, r, -1, g), shortest);
+            cost[g][r] = RA_SoftWeights::level * MissingLevel(in, g, r)
+              + RA_SoftWeights::team_incompatibility * (in.RefereeTeamIncompatible(r, g) ? 1 : 0)
+              + RA_SoftWeights::distance * share;
+          }
+      }
+
+  for (g = 0; g < in.Games(); g++)
+    for (g2 = g + 1; g2 < in.Games(); g2++)
+      if (in.GamesOverlap(g, g2))
+        {
+          gamePairs[g].push_back(pairs.size());
+          gamePairs[g2].push_back(pairs.size());
+          pairs.push_back(make_pair(g, g2));
+        }
+  multipliers.assign(pairs.size() * in.Referees(), 0.0);
+}
+
+// Cheapest crew of game g with the current multipliers, by dynamic programming on
+// (number of referees, experience of the crew capped to the required one)
+double RA_LowerBound::SolveGame(unsigned g, vector<unsigned>& crew) const
+{
+  const double INF = numeric_limits<double>::infinity();
+  unsigned max_referees = in.MaxReferees(g), required = in.GameExperience(g), n, e, ne, i;
+  vector<unsigned> candidates;
+  vector<double> adjusted;
+
+  for (unsigned r = 0; r < in.Referees(); r++)
+    if (cost[g][r] >= 0)
+      {
+        double c = cost[g][r];
+        for (unsigned p : gamePairs[g])
+          c += multipliers[p * in.Referees() + r];
+        candidates.push_back(r);
+        adjusted.push_back(c);
+      }
+
+  // best[i][n][e]: cost of n referees among the first i candidates with experience e
+  unsigned width = (max_referees + 1) * (required + 1);
+  vector<double> best((candidates.size() + 1) * width, INF);
+  auto At = [&](unsigned i, unsigned n, unsigned e) -> double& { return best[i * width + n * (required + 1) + e]; };
+  At(0, 0, 0) = 0.0;
+  for (i = 0; i < candidates.size(); i++)
+    for (n = 0; n <= max_referees; n++)
+      for (e = 0; e <= required; e++)
+        if (At(i, n, e) < INF)
+          {
+            At(i + 1, n, e) = min(At(i + 1, n, e), At(i, n, e));
+            if (n < max_referees)
+              {
+                ne = min(required, e + in.RefereeExperience(candidates[i]));
+                At(i + 1, n + 1, ne) = min(At(i + 1, n + 1, ne), At(i, n, e) + adjusted[i]);
+              }
+          }
+
+  double value = INF;
+  unsigned best_n = 0, best_e = 0;
+  for (n = in.MinReferees(g); n <= max_referees; n++)
+    for (e = 0; e <= required; e++)
+      {
+        double v = At(candidates.size(), n, e) + RA_SoftWeights::optional * (max_referees - n)
+          + RA_SoftWeights::experience * (required - e);
+        if (v < value)
+          {
+            value = v;
+            best_n = n;
+            best_e = e;
+          }
+      }
+
+  // backtrack the crew
+  crew.clear();
+  if (value == INF)
+    return 0.0; // not enough available referees: no bound from this game
+  for (i = candidates.size(); i > 0; i--)
+    if (At(i, best_n, best_e) != At(i - 1, best_n, best_e))
+      {
+        crew.push_back(candidates[i - 1]);
+        best_n--;
+        for (e = 0; e <= required; e++) // experience before taking the candidate
+          if (min(required, e + in.RefereeExperience(candidates[i - 1])) == best_e
+              && At(i - 1, best_n, e) + adjusted[i - 1] == At(i, best_n + 1, best_e))
+            break;
+        best_e = e;
+      }
+  return value;
+}
+
+// Solves the games of the days not taken yet by the other threads
+void RA_LowerBound::SolveDays()
+{
+  unsigned d;
+  while ((d = next_day++) < days.size())
+    for (unsigned g : days[d])
+      values[g] = SolveGame(g, crews[g]);
+}
+
+void RA_LowerBound::Worker()
+{
+  unsigned last_round = 0;
+  unique_lock<mutex> lock(pool_mutex);
+  while (true)
+    {
+      round_started.wait(lock, [&]() { return stop || round != last_round; });
+      if (stop)
+        return;
+      last_round = round;
+      lock.unlock();
+      SolveDays();
+      lock.lock();
+      if (--working == 0)
+        round_done.notify_one();
+    }
+}
+
+// Value of the Lagrangian relaxation for the current multipliers
+double RA_LowerBound::Relaxation()
+{
+  double value = 0.0;
+
+  {
+    lock_guard<mutex> lock(pool_mutex);
+    next_day = 0;
+    working = pool.size();
+    round++;
+  }
+  round_started.notify_all();
+  SolveDays(); // the calling thread works as well
+  {
+    unique_lock<mutex> lock(pool_mutex);
+    round_done.wait(lock, [this]() { return working == 0; });
+  }
+
+  for (unsigned g = 0; g < in.Games(); g++)
+    value += values[g];
+  for (double m : multipliers)
+    value -= m;
+  return value;
+}
+
+int RA_LowerBound::Compute(unsigned iterations, unsigned threads, int upper_bound)
+{
+  unsigned k, p, r, stalled = 0;
+  double bound = -numeric_limits<double>::infinity(), step_factor = 2.0;
+  vector<double> subgradient(multipliers.size());
+
+  fill(multipliers.begin(), multipliers.end(), 0.0);
+  round = 0;
+  stop = false;
+  for (k = 1; k < min<unsigned>(threads, days.size()); k++)
+    pool.emplace_back(&RA_LowerBound::Worker, this);
+
+  for (k = 0; k < iterations || k == 0; k++)
+    {
+      double value = Relaxation();
+      if (value > bound + 1e-9)
+        {
+          bound = value;
+          stalled = 0;
+        }
+      else if (++stalled == 20)
+        { // no progress: shorter steps
+          step_factor /= 2;
+          stalled = 0;
+        }
+
+      // subgradient: how much each relaxed constraint is violated by the relaxed solution
+      double norm = 0.0;
+      fill(subgradient.begin(), subgradient.end(), -1.0);
+      for (p = 0; p < pairs.size(); p++)
+        {
+          for (unsigned r : crews[pairs[p].first])
+            subgradient[p * in.Referees() + r] += 1.0;
+          for (unsigned r : crews[pairs[p].second])
+            subgradient[p * in.Referees() + r] += 1.0;
+        }
+      for (p = 0; p < multipliers.size(); p++)
+        if (multipliers[p] > 0 || subgradient[p] > 0)
+          norm += subgradient[p] * subgradient[p];
+      if (norm == 0.0)
+        break; // the relaxed solution satisfies the relaxed constraints
+
+      double target = upper_bound > 0 ? upper_bound : 1.05 * bound + 1.0;
+      double step = step_factor * max(target - value, 1.0) / norm;
+      for (p = 0; p < pairs.size(); p++)
+        for (r = 0; r < in.Referees(); r++)
+          {
+            double& m = multipliers[p * in.Referees() + r];
+            m = max(0.0, m + step * subgradient[p * in.Referees() + r]);
+          }
+    }
+
+  {
+    lock_guard<mutex> lock(pool_mutex);
+    stop = true;
+  }
+  round_started.notify_all();
+  for (auto& t : pool)
+    t.join();
+  pool.clear();
+  return static_cast<int>(ceil(bound - 1e-6));
+}
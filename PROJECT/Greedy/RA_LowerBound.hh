@@ -0,0 +1,47 @@
+// File RA_LowerBound.hh
+#ifndef RA_LOWERBOUND_HH
+#define RA_LOWERBOUND_HH
+
+#include "RA_Data.hh"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Lower bound on the soft cost (RA_SoftWeights) of any solution that satisfies the hard
+// constraints. Each game gets its cheapest crew among the available referees (exact on level,
+// team incompatibility, experience and optional referees, and a valid share of the daily tour);
+// the no-overlap constraints, the only ones that link the games, are relaxed in the Lagrangian
+// way, one multiplier per pair of overlapping games and referee, and the multipliers are
+// improved with subgradient iterations. The games of each day are solved in parallel, by a
+// pool of threads that lasts for the whole Compute.
+class RA_LowerBound
+{
+public:
+  RA_LowerBound(const RA_Input& in);
+  // upper_bound (the cost of a known solution, if any) drives the step size
+  int Compute(unsigned iterations, unsigned threads, int upper_bound = -1);
+private:
+  const RA_Input& in;
+  vector<vector<double>> cost;                // games x referees, -1 if not eligible
+  vector<pair<unsigned, unsigned>> pairs;     // pairs of overlapping games
+  vector<vector<unsigned>> gamePairs;         // pairs that involve each game
+  vector<vector<unsigned>> days;              // games of each day
+  vector<double> multipliers;                 // pairs x referees
+  vector<vector<unsigned>> crews;             // crew chosen for each game by the last relaxation
+  vector<double> values;                      // value of the crew of each game
+
+  // pool of threads: in each round, the threads take the days one by one
+  vector<thread> pool;
+  mutex pool_mutex;
+  condition_variable round_started, round_done;
+  unsigned round, working;                    // current round, threads still working on it
+  bool stop;
+  atomic<unsigned> next_day;
+
+  double SolveGame(unsigned g, vector<unsigned>& crew) const;
+  void SolveDays();
+  void Worker();
+  double Relaxation();
+};
+#endif
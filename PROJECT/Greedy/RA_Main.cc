@@ -1,65 +1,297 @@
-#include "RA_Helpers.hh"
+// Build (C++17 and POSIX; EASYLOCAL is the directory of the EasyLocal++ headers). RA_Main.cc,
+// RA_Tune.cc, RA_Bench.cc and RA_Generate.cc all define main(), so they are linked into four
+// programs (the solver, the tuner, the neighborhood benchmark and the instance generator):
+//   g++ -std=c++17 -O3 -pthread -I$EASYLOCAL -o ra RA_Main.cc RA_Data.cc RA_Helpers.cc RA_Solver.cc
+//       RA_Checkpoint.cc RA_LowerBound.cc RA_Writer.cc RA_Pool.cc
+//   g++ -std=c++17 -O3 -pthread -I$EASYLOCAL -o ra_tune RA_Tune.cc RA_Data.cc RA_Helpers.cc RA_Solver.cc
+//   g++ -std=c++17 -O3 -g -I$EASYLOCAL -o ra_bench RA_Bench.cc RA_Data.cc RA_Helpers.cc RA_Solver.cc
+//   g++ -std=c++17 -O3 -I$EASYLOCAL -o ra_generate RA_Generate.cc
+#include "RA_Solver.hh"
+#include "RA_Checkpoint.hh"
+#include "RA_LowerBound.hh"
+#include "RA_Writer.hh"
+#include "RA_Pool.hh"
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <memory>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <filesystem>
 
 using namespace EasyLocal::Debug;
 
+// Relative gap of a cost from a lower bound
+static double Gap(int cost, int bound)
+{
+  return cost > 0 ? static_cast<double>(cost - bound) / cost : 0.0;
+}
+
+// Largest cost within target_gap from the lower bound
+static int TargetCost(int bound, double target_gap)
+{
+  if (target_gap >= 1.0)
+    return INT_MAX;
+  return max(0, static_cast<int>(floor(bound / (1.0 - target_gap))));
+}
+
+// Anytime mode: runs the runner until the time budget is over (or the best cost is within
+// target_cost). A runner that stops by itself is restarted from the best solution; with
+// restart_temperature, each SA restart starts colder than the previous one, until the cycle
+// starts again. Each new best solution is appended to the log as "cost, elapsed, iteration"
+// as soon as the runner finds it.
+// With a checkpoint file, the run is cut at each checkpoint time, and the best solution is
+// saved with the iteration and the temperature of the runner. The run then goes on from the
+// best solution at that iteration and temperature, exactly as after a resume from the file.
+// The state of the EasyLocal generator cannot be saved, so each call of the runner reseeds it
+// with seed + round instead. With warm_start, the first run starts from best
+static void RunAnytime(RA_Solver& ra, double restart_temperature, double time_budget, int target_cost, bool warm_start,
+                       const string& log_file, const string& checkpoint_file, double checkpoint_interval,
+                       RA_Output& best, RA_Checkpoint& cp)
+{
+  ofstream log;
+  auto start = chrono::steady_clock::now();
+  double start_elapsed = cp.elapsed, last_checkpoint = cp.elapsed;
+  auto Elapsed = [&]() { return start_elapsed + chrono::duration<double>(chrono::steady_clock::now() - start).count(); };
+  RA_Continuable& runner = ra.SelectedRunner();
+
+  if (!log_file.empty())
+    {
+      log.open(log_file, ios::app);
+      // flushed, so that the log can be followed while the search runs
+      runner.new_best = [&](int cost, unsigned long iteration)
+      {
+        log << cost << ", " << Elapsed() << ", " << iteration << endl;
+      };
+    }
+  while (Elapsed() < time_budget && (cp.round == 0 || cp.cost > target_cost))
+    {
+      double timeout = time_budget - Elapsed(), until_checkpoint = last_checkpoint + checkpoint_interval - Elapsed();
+      bool checkpoint_due = !checkpoint_file.empty() && until_checkpoint < timeout;
+      ra.solver.SetParameter("timeout", checkpoint_due ? max(until_checkpoint, 0.0) : timeout);
+      if (cp.iteration > 0)
+        runner.Continue(cp.iteration, cp.temperature);
+      else if (ra.IsSA() && cp.restart_temperature > 0)
+        ra.sa.SetParameter("start_temperature", cp.restart_temperature);
+      Random::SetSeed(cp.seed + cp.round);
+      SolverResult<RA_Input, RA_Output> result = cp.round == 0 && !warm_start ? ra.solver.Solve() : ra.solver.Resolve(best);
+      cp.round++;
+      if (cp.round == 1 || result.cost.total < cp.cost)
+        {
+          best = result.output;
+          cp.cost = result.cost.total;
+        }
+      if (runner.Stopped())
+        {
+          cp.iteration = 0;
+          cp.temperature = 0.0;
+          if (cp.restart_temperature > 0)
+            {
+              cp.restart_temperature /= 2;
+              if (cp.restart_temperature < 1.0)
+                cp.restart_temperature = restart_temperature;
+            }
+        }
+      else
+        { // cut by the timeout: the next call continues the run
+          cp.iteration = runner.Iteration();
+          cp.temperature = runner.Temperature();
+        }
+      cp.elapsed = Elapsed();
+      if (checkpoint_due)
+        {
+          WriteCheckpoint(checkpoint_file, cp, best);
+          last_checkpoint = cp.elapsed;
+        }
+    }
+  runner.new_best = nullptr;
+  if (!checkpoint_file.empty())
+    WriteCheckpoint(checkpoint_file, cp, best);
+}
+
+// Batch mode: solves all the instances on a pool of worker processes (see RunWorkers), writing
+// one solution file (in the given format) and one summary row per instance. Instance i is
+// solved with seed + i, so that a batch is reproducible. Each worker reads its instance and
+// builds its solver (whose runner options are parsed there), so that the parent holds nothing
+// per instance and an instance that cannot be read fails alone
+static int RunBatch(int argc, const char* argv[], const string& instances, const string& method, bool fused,
+                    unsigned threads, int seed, const string& output_dir, const RA_SAParameters* parameters,
+                    unsigned bound_iterations, double target_gap, RA_Format format,
+                    const string& pool_dir, unsigned pool_size, int balance_weight, bool reorder)
+{
+  vector<string> files = ExpandInstances(instances);
+
+  if (files.empty())
+    {
+      cerr << "No instances found in " << instances << endl;
+      return 1;
+    }
+  filesystem::create_directories(output_dir);
+
+  // solves instance i (in a worker process), returning its summary row
+  auto Solve = [&](unsigned i) -> string
+  {
+    RA_Input in(files[i], reorder);
+    RA_Solver ra(in, fused, balance_weight);
+    int bound = 0;
+    ra.SetMethod(method);
+    if (!CommandLineParameters::Parse(argc, argv, true, false))
+      return "";
+    if (parameters != nullptr)
+      ra.SetSAParameters(*parameters);
+    Random::SetSeed(seed + i);
+    if (bound_iterations > 0)
+      { // the instances already run in parallel: one thread for the bound
+        RA_LowerBound lb(in);
+        bound = lb.Compute(bound_iterations, 1);
+        ra.sm.SetTargetCost(TargetCost(bound, target_gap));
+      }
+    unique_ptr<RA_Pool> pool;
+    RA_Output start(in);
+    bool warm_start = false;
+    if (!pool_dir.empty())
+      {
+        pool.reset(new RA_Pool(in, pool_dir, pool_size, balance_weight));
+        warm_start = pool->WarmStart(ra.sm, start);
+      }
+    SolverResult<RA_Input, RA_Output> result = warm_start ? ra.solver.Resolve(start) : ra.solver.Solve();
+    if (pool)
+      {
+        pool->Insert(result.output, result.cost.total);
+        pool->Save();
+      }
+    string name = filesystem::path(files[i]).stem().string();
+    RA_Writer writer(in);
+    if (!writer.Format(result.output, format, RA_Summary{result.cost.total, result.running_time,
+                                                         bound_iterations > 0 ? bound : -1, Gap(result.cost.total, bound)})
+        || !writer.Write(output_dir + "/" + name + FormatExtension(format)))
+      return "";
+    ostringstream row;
+    row << name << "," << result.cost.total << "," << result.cost.violations << ","
+        << result.cost.objective << "," << result.running_time << ",";
+    if (bound_iterations > 0)
+      row << bound << "," << Gap(result.cost.total, bound);
+    else
+      row << ",";
+    row << "\n";
+    return row.str();
+  };
+
+  vector<string> rows;
+  int status = 0;
+  RunWorkers(files.size(), threads, Solve, rows);
+  for (unsigned i = 0; i < files.size(); i++)
+    if (rows[i].empty())
+      {
+        cerr << "Solving " << files[i] << " failed" << endl;
+        status = 1;
+      }
+
+  ofstream summary(output_dir + "/summary.csv");
+  summary << "instance,cost,violations,objective,time,lower_bound,gap" << "\n";
+  for (const auto& row : rows)
+    summary << row;
+  return status;
+}
+
 int main(int argc, const char* argv[])
 {
   ParameterBox main_parameters("main", "Main Program options");
   Parameter<string> instance("instance", "Input instance", main_parameters); 
+  Parameter<string> instances("instances", "Batch mode: directory, pattern or list file of instances", main_parameters);
+  Parameter<unsigned> threads("threads", "Instances solved in parallel (batch mode), or threads of the lower bound", main_parameters);
+  Parameter<string> output_dir("output_dir", "Batch mode: directory for the solutions and summary.csv", main_parameters);
   Parameter<int> seed("seed", "Random seed", main_parameters);
   Parameter<string> method("method", "Solution method (empty for tester)", main_parameters);   
   Parameter<string> init_state("init_state", "Initial state (to be read from file)", main_parameters);
   Parameter<string> output_file("output_file", "Write the output to a file (filename required)", main_parameters);
+  Parameter<string> output_format("output_format", "Output format: text (default), json, csv or binary", main_parameters);
+  Parameter<string> evaluator("evaluator", "Delta evaluation: fused (default) or components (for debugging)", main_parameters);
+  Parameter<string> parameter_file("parameter_file", "SA parameters (e.g. from RA_Tune), overriding the SA options", main_parameters);
+  Parameter<double> time_budget("time_budget", "Anytime mode: total running time in seconds", main_parameters);
+  Parameter<string> log_file("log_file", "Anytime mode: append each new best cost (cost, elapsed, iteration) to a file", main_parameters);
+  Parameter<string> checkpoint_file("checkpoint_file", "Anytime mode: checkpoint file (resume from it if it exists)", main_parameters);
+  Parameter<double> checkpoint_interval("checkpoint_interval", "Anytime mode: maximum seconds between two checkpoints (default 60)", main_parameters);
+  Parameter<double> restart_temperature("restart_temperature", "Anytime mode: start temperature of the SA restarts", main_parameters);
+  Parameter<bool> reorder("reorder", "Store games by date/time/arena and referees by location (output in file order)", main_parameters);
+  Parameter<int> balance_weight("balance_weight", "Weight of the referee workload balance (default 0 = off)", main_parameters);
+  Parameter<string> pool_dir("pool_dir", "Directory of the solution pool: warm start from it and store the result", main_parameters);
+  Parameter<unsigned> pool_size("pool_size", "Elite solutions kept in the pool for each instance", main_parameters);
+  Parameter<unsigned> bound_iterations("bound_iterations", "Subgradient iterations of the lower bound (reports the gap)", main_parameters);
+  Parameter<double> target_gap("target_gap", "Stop as soon as the gap from the lower bound is within this fraction", main_parameters);
  
   // 3rd parameter: false = do not check unregistered parameters
   // 4th parameter: true = silent
   CommandLineParameters::Parse(argc, argv, false, true);  
 
+  if (seed.IsSet())
+    Random::SetSeed(seed);
+
+  RA_SAParameters parameters;
+  if (parameter_file.IsSet() && !ReadSAParameters(parameter_file, parameters))
+    {
+      cout << "Error: cannot read the parameter file " << static_cast<string>(parameter_file) << endl;
+      return 1;
+    }
+
+  // the target gap needs a bound
+  unsigned iterations = bound_iterations.IsSet() ? static_cast<unsigned>(bound_iterations) : (target_gap.IsSet() ? 200 : 0);
+  double gap = target_gap.IsSet() ? static_cast<double>(target_gap) : 0.0;
+
+  RA_Format format = RA_Format::TEXT;
+  if (output_format.IsSet() && !ParseFormat(output_format, format))
+    {
+      cout << "Error: unknown output format " << static_cast<string>(output_format) << endl;
+      return 1;
+    }
+
+  string evaluation = evaluator.IsSet() ? static_cast<string>(evaluator) : "fused";
+  if (evaluation != "fused" && evaluation != "components")
+    {
+      cout << "Error: unknown evaluator " << evaluation << endl;
+      return 1;
+    }
+
+  if (instances.IsSet())
+    {
+      if (!method.IsSet() || !RA_Solver::IsMethod(method))
+        {
+          cout << "Error: --main::method must be set to a known method in batch mode" << endl;
+          return 1;
+        }
+      if (time_budget.IsSet() || log_file.IsSet() || checkpoint_file.IsSet() || restart_temperature.IsSet())
+        {
+          cout << "Error: the anytime mode options cannot be used in batch mode" << endl;
+          return 1;
+        }
+      return RunBatch(argc, argv, instances, method, evaluation == "fused",
+                      threads.IsSet() ? static_cast<unsigned>(threads) : max(1u, thread::hardware_concurrency()),
+                      seed.IsSet() ? static_cast<int>(seed) : static_cast<int>(random_device()() >> 1),
+                      output_dir.IsSet() ? static_cast<string>(output_dir) : ".",
+                      parameter_file.IsSet() ? &parameters : nullptr, iterations, gap, format,
+                      pool_dir.IsSet() ? static_cast<string>(pool_dir) : "", pool_size.IsSet() ? static_cast<unsigned>(pool_size) : 5,
+                      balance_weight.IsSet() ? static_cast<int>(balance_weight) : 0, reorder.IsSet() && reorder);
+    }
+
   if (!instance.IsSet())
     {
       cout << "Error: --main::instance filename option must always be set" << endl;
       return 1;
     }
-  WL_Input in(instance);
-
-  if (seed.IsSet())
-    Random::SetSeed(seed);
-  
-  // cost components: second parameter is the cost, third is the type (true -> hard, false -> soft)
-  WL_Supply cc1(in, 1, false);
-  WL_Opening cc2(in, 1, false);
-  WL_Capacity cc3(in, 1, true);
- 
-  WL_ChangeDeltaSupply dcc1(in, cc1);
-  WL_ChangeDeltaOpening dcc2(in, cc2);
-  WL_ChangeDeltaCapacity dcc3(in, cc3);
-
-  // helpers
-  WL_SolutionManager WL_sm(in);
-  WL_ChangeNeighborhoodExplorer WL_nhe(in, WL_sm);
-  
-  // All cost components must be added to the state manager
-  WL_sm.AddCostComponent(cc1);
-  WL_sm.AddCostComponent(cc2);
-  WL_sm.AddCostComponent(cc3);
-  
-  // All delta cost components must be added to the neighborhood explorer
-  WL_nhe.AddDeltaCostComponent(dcc1);
-  WL_nhe.AddDeltaCostComponent(dcc2);
-  WL_nhe.AddDeltaCostComponent(dcc3);
-  
-  // runners
-  HillClimbing<WL_Input, WL_Output, WL_Change> WL_hc(in, WL_sm, WL_nhe, "HC");
-  SteepestDescent<WL_Input, WL_Output, WL_Change> WL_sd(in, WL_sm, WL_nhe, "SD");
-  SimulatedAnnealing<WL_Input, WL_Output, WL_Change> WL_sa(in, WL_sm, WL_nhe, "SA");
+  RA_Input in(instance, reorder.IsSet() && reorder);
+  RA_Solver ra(in, evaluation == "fused", balance_weight.IsSet() ? static_cast<int>(balance_weight) : 0);
 
   // tester
-  Tester<WL_Input, WL_Output> tester(in, WL_sm);
-  MoveTester<WL_Input, WL_Output, WL_Change> swap_move_test(in, WL_sm, WL_nhe, "WL_Change move", tester); 
+  Tester<RA_Input, RA_Output> tester(in, ra.sm);
+  MoveTester<RA_Input, RA_Output, RA_Change> swap_move_test(in, ra.sm, ra.nhe, "RA_Change move", tester); 
 
-  SimpleLocalSearch<WL_Input, WL_Output> WL_solver(in, WL_sm, "WL solver");
   if (!CommandLineParameters::Parse(argc, argv, true, false))
     return 1;
+  if (parameter_file.IsSet())
+    ra.SetSAParameters(parameters);
 
   if (!method.IsSet())
     { // if no search method is set -> enter the tester
@@ -70,39 +302,62 @@ int main(int argc, const char* argv[])
     }
   else
     {
-      if (method == "SA")
+      if (!ra.SetMethod(method))
         {
-          WL_solver.SetRunner(WL_sa);
+          cerr << "Unknown method " << static_cast<string>(method) << endl;
+          exit(1);
         }
-      else if (method == "HC")
+      RA_Output out(in);
+      RA_Writer writer(in);
+      int cost, bound = 0, target_cost = 0;
+      unique_ptr<RA_Pool> pool;
+      bool warm_start = false;
+      if (pool_dir.IsSet())
         {
-          WL_solver.SetRunner(WL_hc);
+          pool.reset(new RA_Pool(in, pool_dir, pool_size.IsSet() ? static_cast<unsigned>(pool_size) : 5,
+                                 balance_weight.IsSet() ? static_cast<int>(balance_weight) : 0));
+          warm_start = pool->WarmStart(ra.sm, out);
+          if (warm_start)
+            cerr << "Warm start from the solution pool in " << static_cast<string>(pool_dir) << endl;
         }
-      else if (method == "SD")
+      if (iterations > 0)
         {
-          WL_solver.SetRunner(WL_sd);
+          RA_LowerBound lb(in);
+          bound = lb.Compute(iterations, threads.IsSet() ? static_cast<unsigned>(threads) : max(1u, thread::hardware_concurrency()));
+          target_cost = TargetCost(bound, gap);
+          ra.sm.SetTargetCost(target_cost);
         }
-	  else
-	  {
-		  cerr << "Unknown method " << static_cast<string>(method) << endl;
-		  exit(1);
-	  }
-      SolverResult<WL_Input, WL_Output> result = WL_solver.Solve();
-      WL_Output out = result.output;
-      if (output_file.IsSet())
-        { // write the output on the file passed in the command line
-          ofstream os(static_cast<string>(output_file));
-          os << out << endl;
-          os << "Cost: " << result.cost.total << endl;
-	      os << "Time: " << result.running_time << "s " << endl;
-          os.close();
+      double running_time;
+      if (time_budget.IsSet())
+        {
+          RA_Checkpoint cp{0, seed.IsSet() ? static_cast<int>(seed) : static_cast<int>(random_device()() >> 1),
+                           restart_temperature.IsSet() ? static_cast<double>(restart_temperature) : 0.0, 0, 0.0, 0.0, 0};
+          if (checkpoint_file.IsSet() && ReadCheckpoint(checkpoint_file, cp, out))
+            cerr << "Resuming from " << static_cast<string>(checkpoint_file) << " (round " << cp.round
+                 << ", iteration " << cp.iteration << ", cost " << cp.cost << ", " << cp.elapsed << "s)" << endl;
+          RunAnytime(ra, restart_temperature.IsSet() ? static_cast<double>(restart_temperature) : 0.0, time_budget, target_cost, warm_start,
+                     log_file.IsSet() ? static_cast<string>(log_file) : "",
+                     checkpoint_file.IsSet() ? static_cast<string>(checkpoint_file) : "",
+                     checkpoint_interval.IsSet() ? static_cast<double>(checkpoint_interval) : 60.0, out, cp);
+          cost = cp.cost;
+          running_time = cp.elapsed;
         }
       else
-        { // write the solution in the standard output
-          cout << out << endl;
-          cout << "Cost: " << result.cost.total << endl;
-		  cout << "Time: " << result.running_time << "s " << endl;					
+        {
+          SolverResult<RA_Input, RA_Output> result = warm_start ? ra.solver.Resolve(out) : ra.solver.Solve();
+          out = result.output;
+          cost = result.cost.total;
+          running_time = result.running_time;
+        }
+      if (pool)
+        {
+          pool->Insert(out, cost);
+          pool->Save();
         }
+      // write the output on the file passed in the command line, or in the standard output
+      if (!writer.Format(out, format, RA_Summary{cost, running_time, iterations > 0 ? bound : -1, Gap(cost, bound)})
+          || !writer.Write(output_file.IsSet() ? static_cast<string>(output_file) : ""))
+        return 1;
    }
   return 0;
 }
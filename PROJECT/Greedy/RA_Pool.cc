@@ -0,0 +1,371 @@
+// File RA_Pool.cc
+#include "RA_Pool.hh"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+// FNV-1a, 64 bits
+class Fnv1aHash
+{
+public:
+  Fnv1aHash() : value(14695981039346656037ULL) {}
+  void Add(const void* data, size_t n)
+  {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < n; i++)
+      value = (value ^ p[i]) * 1099511628211ULL;
+  }
+  void Add(const string& s) { Add(s.data(), s.size() + 1); } // with the terminator
+  void Add(unsigned n) { Add(&n, sizeof(n)); }
+  void Add(float x) { Add(&x, sizeof(x)); }
+  uint64_t Value() const { return value; }
+private:
+  uint64_t value;
+};
+
+// The elements are hashed in file order, so that the fingerprint does not depend on the
+// load-time reordering
+uint64_t Fingerprint(const RA_Input& in, int balance_weight)
+{
+  Fnv1aHash h;
+  unsigned g, r, a, a2, i, j;
+
+  h.Add(static_cast<unsigned>(balance_weight));
+  h.Add(in.Referees());
+  h.Add(in.Arenas());
+  h.Add(in.Games());
+  for (i = 0; i < in.Referees(); i++)
+    {
+      r = in.RefereeAt(i);
+      h.Add(in.RefereeCode(r));
+      h.Add(in.RefereeLevel(r));
+      h.Add(in.RefereeExperience(r));
+      for (a = 0; a < in.Arenas(); a++)
+        h.Add(in.DistanceBetweenArenasAndReferee(a, r));
+      for (j = 0; j < in.Referees(); j++)
+        h.Add(in.RefereesIncompatible(r, in.RefereeAt(j)) ? 1u : 0u);
+    }
+  for (a = 0; a < in.Arenas(); a++)
+    for (a2 = 0; a2 < in.Arenas(); a2++)
+      h.Add(in.DistanceBetweenArenas(a, a2));
+  for (i = 0; i < in.Games(); i++)
+    {
+      g = in.GameAt(i);
+      h.Add(in.GameHomeTeamCode(g));
+      h.Add(in.GameGuestTeamCode(g));
+      h.Add(in.GameArena(g));
+      h.Add(in.GameDay(g));
+      h.Add(in.GameStart(g));
+      h.Add(in.GameExperience(g));
+      h.Add(in.MinReferees(g));
+      h.Add(in.MaxReferees(g));
+      h.Add(in.GameLevel(g));
+      for (j = 0; j < in.Referees(); j++)
+        {
+          r = in.RefereeAt(j);
+          h.Add((in.RefereeAvailable(r, g) ? 1u : 0u) | (in.RefereeTeamIncompatible(r, g) ? 2u : 0u));
+        }
+      for (j = 0; j < in.Games(); j++)
+        h.Add(in.GamesOverlap(g, in.GameAt(j)) ? 1u : 0u);
+    }
+  return h.Value();
+}
+
+RA_Pool::RA_Pool(const RA_Input& my_in, const string& my_directory, unsigned my_size, int balance_weight)
+  : in(my_in), directory(my_directory), size(my_size), fingerprint(Fingerprint(my_in, balance_weight))
+{
+  vector<StoredSolution> solutions;
+  RA_Output out(in);
+  int lock = Lock(LOCK_SH);
+  bool loaded = Load(FileName(fingerprint), solutions);
+
+  if (lock != -1)
+    close(lock);
+  if (!loaded)
+    return;
+  for (const auto& stored : solutions)
+    if (elite.size() < size && Map(stored, out, false) == in.Games())
+      elite.push_back(Entry{stored.cost, out});
+}
+
+string RA_Pool::FileName(uint64_t key) const
+{
+  char name[24];
+  snprintf(name, sizeof(name), "%016llx.pool", static_cast<unsigned long long>(key));
+  return directory + "/" + name;
+}
+
+// Without the directory (nothing to read yet) there is no lock: the pool files are replaced
+// by rename, so that an unlocked reader never sees them half written anyway
+int RA_Pool::Lock(int operation) const
+{
+  int fd = open((directory + "/lock").c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd != -1 && flock(fd, operation) == -1)
+    {
+      close(fd);
+      fd = -1;
+    }
+  return fd;
+}
+
+bool RA_Pool::Load(const string& file_name, vector<StoredSolution>& solutions)
+{
+  ifstream is(file_name);
+  string label;
+  unsigned n_solutions, n_games, n_referees, i, j, k;
+
+  solutions.clear();
+  if (!is)
+    return false;
+  is >> label >> label;        // read "Fingerprint: F"
+  is >> label >> n_solutions;  // read "Solutions: N"
+  if (!is)
+    return false;
+  solutions.resize(n_solutions);
+  for (i = 0; i < n_solutions; i++)
+    {
+      is >> label >> solutions[i].cost >> label >> n_games; // read "Cost: C Games: G"
+      if (!is)
+        return false;
+      solutions[i].games.resize(n_games);
+      for (j = 0; j < n_games; j++)
+        {
+          StoredGame& game = solutions[i].games[j];
+          is >> game.home >> game.guest >> game.day >> n_referees;
+          game.referees.resize(n_referees);
+          for (k = 0; k < n_referees; k++)
+            is >> game.referees[k];
+        }
+      if (!is)
+        return false;
+    }
+  return true;
+}
+
+void RA_Pool::Save()
+{
+  vector<StoredSolution> solutions;
+  RA_Output out(in);
+  error_code ec;
+
+  filesystem::create_directories(directory, ec);
+  int lock = Lock(LOCK_EX);
+  if (lock == -1)
+    {
+      cerr << "Cannot lock the pool directory " << directory << endl;
+      return;
+    }
+  // solutions saved by concurrent runs (or by runs of instance files with the same content)
+  bool known = Load(FileName(fingerprint), solutions);
+  for (const auto& stored : solutions)
+    if (Map(stored, out, false) == in.Games())
+      Insert(out, stored.cost);
+  Write();
+  if (!known)
+    AddToIndex();
+  close(lock);
+}
+
+// Called with the exclusive lock held
+void RA_Pool::Write() const
+{
+  string file_name = FileName(fingerprint), tmp_name = file_name + ".tmp";
+  unsigned i, g;
+
+  ofstream os(tmp_name);
+  os << "Fingerprint: " << hex << fingerprint << dec << "\n";
+  os << "Solutions: " << elite.size() << "\n";
+  for (const auto& entry : elite)
+    {
+      os << "Cost: " << entry.cost << " Games: " << in.Games() << "\n";
+      for (i = 0; i < in.Games(); i++)
+        {
+          g = in.GameAt(i);
+          os << in.GameHomeTeamCode(g) << " " << in.GameGuestTeamCode(g) << " " << in.GameDay(g)
+             << " " << entry.solution.AssignedReferees(g).size();
+          for (unsigned r : entry.solution.AssignedReferees(g))
+            os << " " << in.RefereeCode(r);
+          os << "\n";
+        }
+    }
+  os.close();
+  if (!os)
+    {
+      cerr << "Cannot write pool file " << tmp_name << endl;
+      return;
+    }
+  if (rename(tmp_name.c_str(), file_name.c_str()) != 0)
+    cerr << "Cannot rename pool file " << tmp_name << " to " << file_name << endl;
+}
+
+// Index: one line per fingerprint, "F G" followed by G triples "home guest day"
+bool RA_Pool::LoadIndex(const string& file_name, vector<IndexEntry>& index)
+{
+  ifstream is(file_name);
+  IndexEntry entry;
+  unsigned n_games;
+
+  index.clear();
+  if (!is)
+    return false;
+  while (is >> hex >> entry.fingerprint >> dec >> n_games)
+    {
+      entry.games.resize(n_games);
+      for (auto& game : entry.games)
+        is >> game.home >> game.guest >> game.day;
+      if (!is)
+        break; // last line cut by a crash
+      index.push_back(entry);
+    }
+  return true;
+}
+
+// Called with the exclusive lock held, when the pool file of this instance is created
+void RA_Pool::AddToIndex() const
+{
+  ofstream os(directory + "/index", ios::app);
+  os << hex << fingerprint << dec << " " << in.Games();
+  for (unsigned i = 0; i < in.Games(); i++)
+    {
+      unsigned g = in.GameAt(i);
+      os << " " << in.GameHomeTeamCode(g) << " " << in.GameGuestTeamCode(g) << " " << in.GameDay(g);
+    }
+  os << "\n";
+  if (!os)
+    cerr << "Cannot write the pool index in " << directory << endl;
+}
+
+// Games are matched by teams and day, referees by code. With repair, the assignments that do
+// not fit the instance any more (unavailable, overlapping, crew full) are dropped
+unsigned RA_Pool::Map(const StoredSolution& stored, RA_Output& out, bool repair) const
+{
+  unsigned mapped = 0;
+
+  out.Reset();
+  for (const auto& game : stored.games)
+    {
+      int g = FindGame(game);
+      if (g == -1)
+        continue;
+      mapped++;
+      for (const auto& code : game.referees)
+        {
+          int r = in.RefereeIndex(code);
+          if (r == -1 || out.AssignedReferees(g).size() >= in.MaxReferees(g) || out.IsAssigned(g, r))
+            continue;
+          bool compatible = true;
+          if (repair)
+            {
+              if (!in.RefereeAvailable(r, g))
+                compatible = false;
+              for (unsigned g2 : out.RefereeGames(r))
+                if (in.GamesOverlap(g, g2))
+                  compatible = false;
+            }
+          if (compatible)
+            out.AssignRefereetoGame(g, r);
+        }
+    }
+  return mapped;
+}
+
+bool RA_Pool::WarmStart(RA_SolutionManager& sm, RA_Output& out) const
+{
+  if (!elite.empty())
+    {
+      out = elite[0].solution;
+      return true;
+    }
+
+  // no solution of this instance: the instance of the index that shares most games
+  vector<IndexEntry> index;
+  vector<StoredSolution> solutions;
+  uint64_t best_fingerprint = 0;
+  unsigned best_mapped = 0, best_assignments = 0;
+  int lock = Lock(LOCK_SH);
+  LoadIndex(directory + "/index", index);
+  for (const auto& entry : index)
+    {
+      unsigned mapped = count_if(entry.games.begin(), entry.games.end(),
+                                 [this](const StoredGame& game) { return FindGame(game) != -1; });
+      if (mapped > best_mapped || (mapped == best_mapped && mapped > 0 && entry.fingerprint < best_fingerprint))
+        {
+          best_mapped = mapped;
+          best_fingerprint = entry.fingerprint;
+        }
+    }
+  bool loaded = best_mapped >= (in.Games() + 1) / 2 // less than half of the games: a cold start is as good
+    && Load(FileName(best_fingerprint), solutions);
+  if (lock != -1)
+    close(lock);
+  if (!loaded)
+    return false;
+
+  // the solution (best first) that keeps most assignments once mapped
+  RA_Output candidate(in);
+  for (const auto& stored : solutions)
+    {
+      unsigned assignments = 0;
+      Map(stored, candidate, true);
+      for (unsigned g = 0; g < in.Games(); g++)
+        assignments += candidate.AssignedReferees(g).size();
+      if (assignments > best_assignments)
+        {
+          best_assignments = assignments;
+          out = candidate;
+        }
+    }
+  if (best_assignments == 0)
+    return false;
+  sm.RepairState(out);
+  return true;
+}
+
+unsigned RA_Pool::Distance(const RA_Output& out1, const RA_Output& out2) const
+{
+  unsigned distance = 0;
+  for (unsigned g = 0; g < in.Games(); g++)
+    {
+      for (unsigned r : out1.AssignedReferees(g))
+        if (!out2.IsAssigned(g, r))
+          distance++;
+      for (unsigned r : out2.AssignedReferees(g))
+        if (!out1.IsAssigned(g, r))
+          distance++;
+    }
+  return distance;
+}
+
+void RA_Pool::Insert(const RA_Output& out, int cost)
+{
+  int closest = -1;
+  unsigned i, d, closest_distance = 0;
+
+  for (i = 0; i < elite.size(); i++)
+    {
+      d = Distance(out, elite[i].solution);
+      if (d == 0)
+        { // already in the pool
+          elite[i].cost = min(elite[i].cost, cost);
+          break;
+        }
+      if (elite[i].cost > cost && (closest == -1 || d < closest_distance))
+        {
+          closest = i;
+          closest_distance = d;
+        }
+    }
+  if (i == elite.size())
+    {
+      if (elite.size() < size)
+        elite.push_back(Entry{cost, out});
+      else if (closest != -1)
+        elite[closest] = Entry{cost, out};
+    }
+  stable_sort(elite.begin(), elite.end(), [](const Entry& e1, const Entry& e2) { return e1.cost < e2.cost; });
+}
@@ -0,0 +1,68 @@
+// File RA_Pool.hh
+#ifndef RA_POOL_HH
+#define RA_POOL_HH
+#include "RA_Helpers.hh"
+#include <cstdint>
+
+// Content hash of the parsed instance (codes, times, levels, distances and compatibilities) and
+// of the weight of the balance component, the only weight of the objective that can change
+// between runs: the costs stored in a pool hold for that weight only
+uint64_t Fingerprint(const RA_Input& in, int balance_weight);
+
+// On-disk pool of elite solutions, one file per fingerprint in a directory, plus an
+// index file with the games of each fingerprint. Solutions are stored by codes (teams, day,
+// referees), so that they can be mapped on a modified instance too. The files are read under
+// a shared lock on the directory and written under an exclusive one (flock on directory/lock)
+class RA_Pool
+{
+public:
+  RA_Pool(const RA_Input& in, const string& directory, unsigned size, int balance_weight);
+  // the best solution of this instance or, if there is none, a solution of the instance of the
+  // index that shares most games (same teams and day; ties go to the lowest fingerprint),
+  // mapped and repaired; false if there is none
+  bool WarmStart(RA_SolutionManager& sm, RA_Output& out) const;
+  // diversity-aware replacement: a new solution replaces the most similar of the worse ones
+  void Insert(const RA_Output& out, int cost);
+  // merges the solutions saved by other runs in the meantime, then writes the pool file
+  void Save();
+  unsigned Size() const { return elite.size(); }
+private:
+  struct StoredGame
+  {
+    string home, guest;
+    unsigned day;
+    vector<string> referees;
+  };
+  struct StoredSolution
+  {
+    int cost;
+    vector<StoredGame> games;
+  };
+  struct Entry
+  {
+    int cost;
+    RA_Output solution;
+  };
+  struct IndexEntry
+  {
+    uint64_t fingerprint;
+    vector<StoredGame> games; // without referees
+  };
+
+  const RA_Input& in;
+  string directory;
+  unsigned size;
+  uint64_t fingerprint;
+  vector<Entry> elite; // solutions of this instance, best first
+
+  string FileName(uint64_t key) const;
+  int Lock(int operation) const; // descriptor holding the lock (closing it unlocks), -1 on failure
+  static bool Load(const string& file_name, vector<StoredSolution>& solutions);
+  void Write() const;
+  static bool LoadIndex(const string& file_name, vector<IndexEntry>& index);
+  void AddToIndex() const;
+  int FindGame(const StoredGame& game) const { return in.GameIndex(game.home, game.guest, game.day); }
+  unsigned Map(const StoredSolution& stored, RA_Output& out, bool repair) const; // number of games mapped
+  unsigned Distance(const RA_Output& out1, const RA_Output& out2) const;
+};
+#endif
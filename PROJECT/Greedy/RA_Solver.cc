@@ -0,0 +1,230 @@
+// File RA_Solver.cc
+#include "RA_Solver.hh"
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <fnmatch.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+RA_Solver::RA_Solver(const RA_Input& in, bool fused, int balance_weight)
+  : cc1(in, RA_HardWeights::overlap, true), cc2(in, RA_HardWeights::availability, true),
+    cc3(in, RA_SoftWeights::level, false), cc4(in, RA_SoftWeights::experience, false),
+    cc5(in, RA_SoftWeights::distance, false), cc6(in, RA_SoftWeights::optional, false),
+    cc7(in, RA_SoftWeights::referee_incompatibility, false), cc8(in, RA_SoftWeights::team_incompatibility, false),
+    cc9(in, balance_weight, false),
+    dcc1(in, cc1), dcc2(in, cc2), dcc3(in, cc3), dcc4(in, cc4),
+    dcc5(in, cc5), dcc6(in, cc6), dcc7(in, cc7), dcc8(in, cc8), dcc9(in, cc9),
+    hard_cc(in, true, "RA_FusedHard"), soft_cc(in, false, "RA_FusedSoft"),
+    hard_dcc(in, hard_cc, "RA_ChangeDeltaFusedHard"), soft_dcc(in, soft_cc, "RA_ChangeDeltaFusedSoft"),
+    sm(in), nhe(in, sm),
+    hc(in, sm, nhe, "HC"), sd(in, sm, nhe, "SD"), sa(in, sm, nhe, "SA"),
+    solver(in, sm, "RA solver"), sa_selected(false), selected_runner(nullptr)
+{
+  if (balance_weight > 0)
+    {
+      sm.AddCostComponent(cc9);
+      nhe.AddDeltaCostComponent(dcc9);
+    }
+
+  if (fused)
+    {
+      sm.AddCostComponent(hard_cc);
+      sm.AddCostComponent(soft_cc);
+      nhe.AddDeltaCostComponent(hard_dcc);
+      nhe.AddDeltaCostComponent(soft_dcc);
+      return;
+    }
+
+  // All cost components must be added to the state manager
+  sm.AddCostComponent(cc1);
+  sm.AddCostComponent(cc2);
+  sm.AddCostComponent(cc3);
+  sm.AddCostComponent(cc4);
+  sm.AddCostComponent(cc5);
+  sm.AddCostComponent(cc6);
+  sm.AddCostComponent(cc7);
+  sm.AddCostComponent(cc8);
+
+  // All delta cost components must be added to the neighborhood explorer
+  nhe.AddDeltaCostComponent(dcc1);
+  nhe.AddDeltaCostComponent(dcc2);
+  nhe.AddDeltaCostComponent(dcc3);
+  nhe.AddDeltaCostComponent(dcc4);
+  nhe.AddDeltaCostComponent(dcc5);
+  nhe.AddDeltaCostComponent(dcc6);
+  nhe.AddDeltaCostComponent(dcc7);
+  nhe.AddDeltaCostComponent(dcc8);
+}
+
+bool RA_Solver::SetMethod(const string& method)
+{
+  sa_selected = false;
+  if (method == "SA")
+    {
+      solver.SetRunner(sa);
+      selected_runner = &sa;
+      sa_selected = true;
+    }
+  else if (method == "HC")
+    {
+      solver.SetRunner(hc);
+      selected_runner = &hc;
+    }
+  else if (method == "SD")
+    {
+      solver.SetRunner(sd);
+      selected_runner = &sd;
+    }
+  else
+    return false;
+  return true;
+}
+
+void RA_Solver::SetSAParameters(const RA_SAParameters& p)
+{
+  sa.SetParameter("start_temperature", p.start_temperature);
+  sa.SetParameter("cooling_rate", p.cooling_rate);
+  sa.SetParameter("neighbors_sampled", p.neighbors_sampled);
+  sa.SetParameter("neighbors_accepted", p.neighbors_accepted);
+  if (p.max_evaluations > 0)
+    sa.SetParameter("max_evaluations", p.max_evaluations);
+}
+
+bool ReadSAParameters(const string& file_name, RA_SAParameters& p)
+{
+  string flag;
+  unsigned read = 0;
+  ifstream is(file_name);
+
+  p.max_evaluations = 0;
+  while (is >> flag)
+    {
+      if (flag == "start_temperature")
+        is >> p.start_temperature;
+      else if (flag == "cooling_rate")
+        is >> p.cooling_rate;
+      else if (flag == "neighbors_sampled")
+        is >> p.neighbors_sampled;
+      else if (flag == "neighbors_accepted")
+        is >> p.neighbors_accepted;
+      else if (flag == "max_evaluations")
+        {
+          is >> p.max_evaluations;
+          continue;
+        }
+      else
+        {
+          cerr << "Unknown parameter " << flag << " in " << file_name << endl;
+          return false;
+        }
+      read++;
+    }
+  return read == 4;
+}
+
+void WriteSAParameters(const string& file_name, const RA_SAParameters& p)
+{
+  ofstream os(file_name);
+  os.precision(10);
+  os << "start_temperature " << p.start_temperature << "\n";
+  os << "cooling_rate " << p.cooling_rate << "\n";
+  os << "neighbors_sampled " << p.neighbors_sampled << "\n";
+  os << "neighbors_accepted " << p.neighbors_accepted << "\n";
+  if (p.max_evaluations > 0)
+    os << "max_evaluations " << p.max_evaluations << "\n";
+}
+
+vector<string> ExpandInstances(const string& instances)
+{
+  vector<string> files;
+  filesystem::path path(instances);
+  string pattern = path.filename().string();
+
+  if (filesystem::is_directory(path))
+    {
+      for (const auto& entry : filesystem::directory_iterator(path))
+        if (entry.is_regular_file())
+          files.push_back(entry.path().string());
+    }
+  else if (pattern.find_first_of("*?[") != string::npos)
+    {
+      filesystem::path dir = path.has_parent_path() ? path.parent_path() : filesystem::path(".");
+      for (const auto& entry : filesystem::directory_iterator(dir))
+        if (entry.is_regular_file() && fnmatch(pattern.c_str(), entry.path().filename().c_str(), 0) == 0)
+          files.push_back(entry.path().string());
+    }
+  else
+    {
+      string file;
+      ifstream is(instances);
+      while (is >> file)
+        files.push_back(file);
+    }
+  sort(files.begin(), files.end());
+  return files;
+}
+
+// A result is far smaller than the pipe buffer, so each pipe is read once its process has exited
+bool RunWorkers(unsigned n, unsigned workers, const function<string(unsigned)>& task, vector<string>& results)
+{
+  map<pid_t, pair<unsigned, int>> running; // pid -> task, read end of the pipe
+  unsigned next = 0;
+  bool success = true;
+
+  results.assign(n, "");
+  cout.flush(); // otherwise the buffered output is written by the children too
+  cerr.flush();
+  while (next < n || !running.empty())
+    {
+      if (next < n && running.size() < max(1u, workers))
+        {
+          int fds[2];
+          pid_t pid = -1;
+          if (pipe(fds) == 0 && (pid = fork()) == -1)
+            {
+              close(fds[0]);
+              close(fds[1]);
+            }
+          if (pid == -1)
+            { // the tasks not started yet fail
+              cerr << "Cannot start a worker process" << endl;
+              next = n;
+              success = false;
+              continue;
+            }
+          if (pid == 0)
+            {
+              close(fds[0]);
+              string result = task(next);
+              bool sent = write(fds[1], result.data(), result.size()) == static_cast<ssize_t>(result.size());
+              cout.flush();
+              cerr.flush();
+              _exit(sent ? 0 : 1);
+            }
+          close(fds[1]);
+          running[pid] = make_pair(next++, fds[0]);
+          continue;
+        }
+
+      int status;
+      pid_t pid = waitpid(-1, &status, 0);
+      auto worker = running.find(pid);
+      if (pid == -1 || worker == running.end())
+        continue; // interrupted
+      unsigned i = worker->second.first;
+      char buffer[256];
+      ssize_t read_size;
+      while ((read_size = read(worker->second.second, buffer, sizeof(buffer))) > 0)
+        results[i].append(buffer, read_size);
+      close(worker->second.second);
+      running.erase(worker);
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+          results[i].clear();
+          success = false;
+        }
+    }
+  return success;
+}
@@ -0,0 +1,160 @@
+// File RA_Solver.hh
+#ifndef RA_SOLVER_HH
+#define RA_SOLVER_HH
+
+#include "RA_Fused.hh"
+#include <functional>
+#include <type_traits>
+
+// Weights of the cost components, split in the hard and the soft group (0 = not in the group)
+struct RA_HardWeights
+{
+  static constexpr int overlap = 1, availability = 1, level = 0, experience = 0, distance = 0,
+    optional = 0, referee_incompatibility = 0, team_incompatibility = 0;
+};
+
+struct RA_SoftWeights
+{
+  static constexpr int overlap = 0, availability = 0, level = 20, experience = 10, distance = 1,
+    optional = 100, referee_incompatibility = 100, team_incompatibility = 100;
+};
+
+// Parameters of the SA runner, as read from/written to a parameter file ("flag value" per line).
+// max_evaluations is the budget the parameters were tuned for (0 = none, optional in the file)
+struct RA_SAParameters
+{
+  double start_temperature;
+  double cooling_rate;
+  unsigned neighbors_sampled;
+  unsigned neighbors_accepted;
+  unsigned long max_evaluations;
+};
+
+bool ReadSAParameters(const string& file_name, RA_SAParameters& p); // false if the file is not valid
+void WriteSAParameters(const string& file_name, const RA_SAParameters& p);
+
+// Instances given as a directory, a pattern on the file name (e.g. Instances/RA-3-*.txt)
+// or a file with one instance per line
+vector<string> ExpandInstances(const string& instances);
+
+// Runs task(0), ..., task(n - 1) in child processes, at most workers at a time, and collects the
+// string returned by each task (sent back through a pipe). Processes and not threads, because
+// all the runners draw from the random generator of EasyLocal, which is one per process.
+// The result of a task whose process failed is empty; false if any task failed
+bool RunWorkers(unsigned n, unsigned workers, const function<string(unsigned)>& task, vector<string>& results);
+
+// What the anytime mode needs from the runner: a report of each new best solution, and the
+// continuation of a run that was cut by the timeout (at a checkpoint, or before a resume)
+class RA_Continuable
+{
+public:
+  virtual ~RA_Continuable() {}
+  function<void(int, unsigned long)> new_best; // cost and iteration of each new best solution
+  // the next run starts at the given iteration (as the one of its best state) and, for SA,
+  // at the given temperature instead of start_temperature
+  void Continue(unsigned long iteration, double temperature)
+  {
+    continuing = true;
+    continue_iteration = iteration;
+    continue_temperature = temperature;
+  }
+  virtual unsigned long Iteration() const = 0;
+  virtual double Temperature() const = 0; // 0 for the runners without temperature
+  virtual bool Stopped() const = 0;       // the last run met its stopping criterion
+protected:
+  bool continuing = false;
+  unsigned long continue_iteration = 0;
+  double continue_temperature = 0.0;
+};
+
+template <class BaseRunner>
+class RA_Runner : public BaseRunner, public RA_Continuable
+{
+public:
+  RA_Runner(const RA_Input& in, RA_SolutionManager& sm, RA_ChangeNeighborhoodExplorer& nhe, string name)
+    : BaseRunner(in, sm, nhe, name) {}
+  unsigned long Iteration() const override { return this->iteration; }
+  double Temperature() const override
+  {
+    if constexpr (is_same<BaseRunner, SimulatedAnnealing<RA_Input, RA_Output, RA_Change>>::value)
+      return this->temperature;
+    else
+      return 0.0;
+  }
+  bool Stopped() const override { return this->StopCriterion(); }
+protected:
+  void InitializeRun() override
+  {
+    BaseRunner::InitializeRun();
+    if (!continuing)
+      return;
+    this->iteration = continue_iteration;
+    this->iteration_of_best = continue_iteration;
+    if constexpr (is_same<BaseRunner, SimulatedAnnealing<RA_Input, RA_Output, RA_Change>>::value)
+      this->temperature = continue_temperature;
+    continuing = false;
+  }
+  void UpdateBestState() override
+  {
+    int best_cost = this->best_state_cost.total;
+    BaseRunner::UpdateBestState();
+    if (new_best && this->best_state_cost.total < best_cost)
+      new_best(this->best_state_cost.total, this->iteration);
+  }
+};
+
+// All the objects needed to solve one instance: cost components, helpers, runners and solver
+class RA_Solver
+{
+public:
+  // fused = false uses one delta cost component per constraint (slower, for debugging);
+  // balance_weight > 0 adds the workload balance component (with either evaluator)
+  RA_Solver(const RA_Input& in, bool fused = true, int balance_weight = 0);
+  bool SetMethod(const string& method); // false if the method is unknown
+  static bool IsMethod(const string& method) { return method == "SA" || method == "HC" || method == "SD"; }
+  bool IsSA() const { return sa_selected; }
+  void SetSAParameters(const RA_SAParameters& p);
+
+  // cost components: second parameter is the cost, third is the type (true -> hard, false -> soft)
+  RA_Overlap cc1;
+  RA_Availability cc2;
+  RA_Level cc3;
+  RA_Experience cc4;
+  RA_Distance cc5;
+  RA_Optional cc6;
+  RA_RefereeIncompatibility cc7;
+  RA_TeamIncompatibility cc8;
+  RA_Balance cc9; // registered (and evaluated) only if balance_weight > 0
+
+  RA_ChangeDeltaOverlap dcc1;
+  RA_ChangeDeltaAvailability dcc2;
+  RA_ChangeDeltaLevel dcc3;
+  RA_ChangeDeltaExperience dcc4;
+  RA_ChangeDeltaDistance dcc5;
+  RA_ChangeDeltaOptional dcc6;
+  RA_ChangeDeltaRefereeIncompatibility dcc7;
+  RA_ChangeDeltaTeamIncompatibility dcc8;
+  RA_ChangeDeltaBalance dcc9;
+
+  // fused evaluators: one for the hard and one for the soft components
+  RA_Fused<RA_HardWeights> hard_cc;
+  RA_Fused<RA_SoftWeights> soft_cc;
+  RA_ChangeDeltaFused<RA_HardWeights> hard_dcc;
+  RA_ChangeDeltaFused<RA_SoftWeights> soft_dcc;
+
+  // helpers
+  RA_SolutionManager sm;
+  RA_ChangeNeighborhoodExplorer nhe;
+
+  // runners
+  RA_Runner<HillClimbing<RA_Input, RA_Output, RA_Change>> hc;
+  RA_Runner<SteepestDescent<RA_Input, RA_Output, RA_Change>> sd;
+  RA_Runner<SimulatedAnnealing<RA_Input, RA_Output, RA_Change>> sa;
+
+  SimpleLocalSearch<RA_Input, RA_Output> solver;
+  RA_Continuable& SelectedRunner() { return *selected_runner; } // after SetMethod
+private:
+  bool sa_selected;
+  RA_Continuable* selected_runner;
+};
+#endif
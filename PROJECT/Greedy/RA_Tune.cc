@@ -0,0 +1,209 @@
+// File RA_Tune.cc
+// Racing tuner (F-Race) for the parameters of the SA runner: random candidate configurations
+// are evaluated instance after instance, and after each instance the ones that are
+// statistically worse than the best one (Friedman test with post-hoc comparisons) are discarded.
+// All the configurations of a block run with the same seed and the same number of evaluations,
+// so that the runs are paired; the blocks go through the instances in a random order.
+// RA_Tune.cc has its own main(), so it is linked apart from RA_Main.cc (see there)
+#include "RA_Solver.hh"
+#include <cmath>
+#include <random>
+#include <thread>
+#include <string>
+#include <algorithm>
+#include <numeric>
+
+using namespace EasyLocal::Debug;
+
+// Ranks of the values in a block (1 = lowest cost), ties get the average rank
+static vector<double> Ranks(const vector<int>& costs)
+{
+  vector<unsigned> order(costs.size());
+  vector<double> ranks(costs.size());
+  unsigned i, j, k;
+
+  iota(order.begin(), order.end(), 0);
+  sort(order.begin(), order.end(), [&costs](unsigned a, unsigned b) { return costs[a] < costs[b]; });
+  for (i = 0; i < order.size(); i = j)
+    {
+      for (j = i + 1; j < order.size() && costs[order[j]] == costs[order[i]]; j++)
+        ;
+      for (k = i; k < j; k++)
+        ranks[order[k]] = (i + j + 1) / 2.0;
+    }
+  return ranks;
+}
+
+// Quantile of the chi-square distribution at 0.95 (Wilson-Hilferty approximation)
+static double ChiSquare95(unsigned df)
+{
+  const double z = 1.6449;
+  double h = 2.0 / (9.0 * df);
+  return df * pow(1.0 - h + z * sqrt(h), 3);
+}
+
+// Quantile of the Student t distribution at 0.975 (Cornish-Fisher expansion)
+static double Student975(unsigned df)
+{
+  const double z = 1.96;
+  return z + (pow(z, 3) + z) / (4.0 * df) + (5 * pow(z, 5) + 16 * pow(z, 3) + 3 * z) / (96.0 * df * df);
+}
+
+// Friedman test on the blocks evaluated so far (one row per block, one column per alive
+// configuration); returns the columns that are not dominated by the best one
+static vector<unsigned> Race(const vector<vector<int>>& blocks, vector<double>& rank_sums)
+{
+  unsigned b = blocks.size(), k = blocks[0].size(), j;
+  double a = 0.0, statistic = 0.0, squares = 0.0;
+  vector<unsigned> survivors;
+
+  rank_sums.assign(k, 0.0);
+  for (const auto& block : blocks)
+    {
+      vector<double> ranks = Ranks(block);
+      for (j = 0; j < k; j++)
+        {
+          rank_sums[j] += ranks[j];
+          a += ranks[j] * ranks[j];
+        }
+    }
+  double c = b * k * (k + 1) * (k + 1) / 4.0;
+  for (j = 0; j < k; j++)
+    {
+      statistic += (rank_sums[j] - b * (k + 1) / 2.0) * (rank_sums[j] - b * (k + 1) / 2.0);
+      squares += rank_sums[j] * rank_sums[j];
+    }
+  unsigned best = min_element(rank_sums.begin(), rank_sums.end()) - rank_sums.begin();
+  if (a == c || (k - 1) * statistic / (a - c) <= ChiSquare95(k - 1))
+    { // no significant difference: all the configurations survive
+      survivors.resize(k);
+      iota(survivors.begin(), survivors.end(), 0);
+      return survivors;
+    }
+
+  // post-hoc comparisons with the best configuration (Conover)
+  double difference = Student975((b - 1) * (k - 1))
+    * sqrt(2.0 * b * (a - squares / b) / ((b - 1) * (k - 1)));
+  for (j = 0; j < k; j++)
+    if (j == best || rank_sums[j] - rank_sums[best] <= difference)
+      survivors.push_back(j);
+  return survivors;
+}
+
+int main(int argc, const char* argv[])
+{
+  ParameterBox tune_parameters("tune", "Tuner options");
+  Parameter<string> instances("instances", "Training instances: directory, pattern or list file", tune_parameters);
+  Parameter<string> output_file("output_file", "Parameter file for the best configuration", tune_parameters);
+  Parameter<unsigned> configurations("configurations", "Number of candidate configurations (default 32)", tune_parameters);
+  Parameter<unsigned> budget("budget", "Maximum number of runs (default 50 per configuration)", tune_parameters);
+  Parameter<unsigned> first_test("first_test", "Instances evaluated before the first elimination (default 5)", tune_parameters);
+  Parameter<unsigned> evaluations("evaluations", "Evaluations of each run (default 1000000)", tune_parameters);
+  Parameter<unsigned> threads("threads", "Number of runs in parallel (worker processes)", tune_parameters);
+  Parameter<int> seed("seed", "Random seed for the candidate configurations and the blocks", tune_parameters);
+
+  CommandLineParameters::Parse(argc, argv, false, true);
+  if (!instances.IsSet() || !output_file.IsSet())
+    {
+      cout << "Error: --tune::instances and --tune::output_file options must always be set" << endl;
+      return 1;
+    }
+
+  vector<string> files = ExpandInstances(instances);
+  unsigned n_configurations = configurations.IsSet() ? static_cast<unsigned>(configurations) : 32;
+  unsigned max_runs = budget.IsSet() ? static_cast<unsigned>(budget) : 50 * n_configurations;
+  unsigned min_blocks = first_test.IsSet() ? static_cast<unsigned>(first_test) : 5;
+  unsigned long max_evaluations = evaluations.IsSet() ? static_cast<unsigned>(evaluations) : 1000000;
+  unsigned n_workers = threads.IsSet() ? static_cast<unsigned>(threads) : max(1u, thread::hardware_concurrency());
+  mt19937 generator(seed.IsSet() ? static_cast<int>(seed) : random_device()());
+
+  if (files.empty())
+    {
+      cerr << "No instances found in " << static_cast<string>(instances) << endl;
+      return 1;
+    }
+
+  // candidate configurations, sampled on log scales where the range spans orders of magnitude
+  uniform_real_distribution<double> uniform(0.0, 1.0);
+  vector<RA_SAParameters> candidates(n_configurations);
+  for (auto& c : candidates)
+    {
+      c.start_temperature = pow(10.0, 3.0 * uniform(generator));
+      c.cooling_rate = 0.9 + 0.099 * uniform(generator);
+      c.neighbors_sampled = static_cast<unsigned>(pow(10.0, 2.0 + 2.0 * uniform(generator)));
+      c.neighbors_accepted = max(1u, static_cast<unsigned>(c.neighbors_sampled * (0.05 + 0.95 * uniform(generator))));
+      c.max_evaluations = max_evaluations;
+    }
+
+  vector<unsigned> alive(n_configurations);
+  vector<vector<int>> blocks; // costs of the alive configurations, one row per instance
+  vector<double> rank_sums;
+  unsigned runs = 0, block;
+  iota(alive.begin(), alive.end(), 0);
+  for (block = 0; alive.size() > 1 && runs + alive.size() <= max_runs; block++)
+    {
+      unsigned instance = block % files.size();
+      if (instance == 0) // a new pass over the instances, in a new order
+        shuffle(files.begin(), files.end(), generator);
+      int block_seed = static_cast<int>(generator() >> 1);
+      vector<int> costs(alive.size());
+      vector<string> results;
+
+      // each run reads the instance and builds its solver in its worker process, where the
+      // runner options are parsed
+      if (!RunWorkers(alive.size(), n_workers, [&](unsigned i) -> string
+                      {
+                        RA_Input in(files[instance]);
+                        RA_Solver ra(in);
+                        ra.SetMethod("SA");
+                        if (!CommandLineParameters::Parse(argc, argv, true, false))
+                          return "";
+                        ra.SetSAParameters(candidates[alive[i]]);
+                        Random::SetSeed(block_seed);
+                        return to_string(ra.solver.Solve().cost.total);
+                      }, results))
+        {
+          cerr << "A run on " << files[instance] << " failed" << endl;
+          return 1;
+        }
+      for (unsigned i = 0; i < alive.size(); i++)
+        costs[i] = stoi(results[i]);
+      runs += alive.size();
+      blocks.push_back(costs);
+
+      if (blocks.size() >= max(2u, min_blocks))
+        {
+          vector<unsigned> survivors = Race(blocks, rank_sums);
+          if (survivors.size() < alive.size())
+            {
+              vector<unsigned> new_alive;
+              for (auto& row : blocks)
+                {
+                  vector<int> new_row;
+                  for (unsigned j : survivors)
+                    new_row.push_back(row[j]);
+                  row = new_row;
+                }
+              for (unsigned j : survivors)
+                new_alive.push_back(alive[j]);
+              alive = new_alive;
+            }
+        }
+      cout << "Instance " << block + 1 << " (" << files[instance] << "): " << alive.size()
+           << " configurations alive, " << runs << " runs" << endl;
+    }
+
+  if (blocks.empty())
+    {
+      cerr << "The budget is too small to evaluate all the configurations once" << endl;
+      return 1;
+    }
+  // the best configuration is the one with the lowest sum of ranks
+  Race(blocks, rank_sums);
+  const RA_SAParameters& best = candidates[alive[min_element(rank_sums.begin(), rank_sums.end()) - rank_sums.begin()]];
+  WriteSAParameters(output_file, best);
+  cout << "Best configuration: start_temperature " << best.start_temperature << ", cooling_rate " << best.cooling_rate
+       << ", neighbors_sampled " << best.neighbors_sampled << ", neighbors_accepted " << best.neighbors_accepted
+       << " (" << best.max_evaluations << " evaluations)" << endl;
+  return 0;
+}
@@ -0,0 +1,326 @@
+// File RA_Writer.cc
+#include "RA_Writer.hh"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+bool ParseFormat(const string& name, RA_Format& format)
+{
+  if (name == "text")
+    format = RA_Format::TEXT;
+  else if (name == "json")
+    format = RA_Format::JSON;
+  else if (name == "csv")
+    format = RA_Format::CSV;
+  else if (name == "binary")
+    format = RA_Format::BINARY;
+  else
+    return false;
+  return true;
+}
+
+const char* FormatExtension(RA_Format format)
+{
+  switch (format)
+    {
+    case RA_Format::JSON: return ".json";
+    case RA_Format::CSV: return ".csv";
+    case RA_Format::BINARY: return ".bin";
+    default: return ".sol";
+    }
+}
+
+RA_Writer::RA_Writer(const RA_Input& my_in)
+  : in(my_in), size(0)
+{
+  // an upper bound of the size of any format, so that formatting never reallocates (codes are
+  // counted twice, for the escapes; only control characters in JSON could exceed that)
+  size_t referee_code = 0, team_code = 0, capacity = 256;
+  unsigned g, r;
+  for (r = 0; r < in.Referees(); r++)
+    referee_code = max(referee_code, in.RefereeCode(r).size());
+  for (g = 0; g < in.Games(); g++)
+    team_code = max(team_code, max(in.GameHomeTeamCode(g).size(), in.GameGuestTeamCode(g).size()));
+  for (g = 0; g < in.Games(); g++)
+    capacity += (in.MaxReferees(g) + 1) * (2 * referee_code + 4 * team_code + 64);
+  capacity += in.Referees() * (2 * referee_code + 32);
+  buffer.resize(capacity);
+}
+
+char* RA_Writer::Reserve(size_t n)
+{
+  if (size + n > buffer.size()) // not expected, see the constructor
+    buffer.resize(2 * (size + n));
+  return buffer.data() + size;
+}
+
+void RA_Writer::AppendNumber(long n)
+{
+  char digits[24];
+  Append(digits, snprintf(digits, sizeof(digits), "%ld", n));
+}
+
+void RA_Writer::AppendNumber(double x)
+{
+  char digits[32];
+  Append(digits, snprintf(digits, sizeof(digits), "%g", x));
+}
+
+void RA_Writer::AppendLittleEndian(uint64_t v, unsigned bytes)
+{
+  for (unsigned i = 0; i < bytes; i++, v >>= 8)
+    Append(static_cast<char>(v & 0xff));
+}
+
+void RA_Writer::AppendJSON(const string& s)
+{
+  for (char c : s)
+    if (c == '"' || c == '\\')
+      {
+        Append('\\');
+        Append(c);
+      }
+    else if (static_cast<unsigned char>(c) < 0x20)
+      {
+        char escape[8];
+        Append(escape, snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(c)));
+      }
+    else
+      Append(c);
+}
+
+void RA_Writer::AppendCSV(const string& s)
+{
+  if (s.find_first_of(",\"\r\n") == string::npos)
+    {
+      Append(s);
+      return;
+    }
+  Append('"');
+  for (char c : s)
+    {
+      if (c == '"')
+        Append('"');
+      Append(c);
+    }
+  Append('"');
+}
+
+bool RA_Writer::Format(const RA_Output& out, RA_Format format, const RA_Summary& summary)
+{
+  size = 0;
+  switch (format)
+    {
+    case RA_Format::TEXT: FormatText(out, summary); break;
+    case RA_Format::JSON: FormatJSON(out, summary); break;
+    case RA_Format::CSV: FormatCSV(out); break;
+    case RA_Format::BINARY: return FormatBinary(out, summary);
+    }
+  return true;
+}
+
+void RA_Writer::FormatText(const RA_Output& out, const RA_Summary& summary)
+{
+  for (unsigned i = 0; i < in.Games(); i++)
+    {
+      unsigned g = in.GameAt(i);
+      Append(in.GameHomeTeamCode(g));
+      Append(' ');
+      Append(in.GameGuestTeamCode(g));
+      Append(' ');
+      AppendNumber(static_cast<long>(out.AssignedReferees(g).size()));
+      for (unsigned r : out.AssignedReferees(g))
+        {
+          Append(' ');
+          Append(in.RefereeCode(r));
+        }
+      Append('\n');
+    }
+  Append("\nCost: ");
+  AppendNumber(static_cast<long>(summary.cost));
+  Append("\nTime: ");
+  AppendNumber(summary.time);
+  Append("s \n");
+  if (summary.bound >= 0)
+    {
+      Append("Lower bound: ");
+      AppendNumber(static_cast<long>(summary.bound));
+      Append("\nGap: ");
+      AppendNumber(summary.gap);
+      Append('\n');
+    }
+}
+
+void RA_Writer::FormatJSON(const RA_Output& out, const RA_Summary& summary)
+{
+  unsigned g, r, i, j;
+  Append("{\"cost\":");
+  AppendNumber(static_cast<long>(summary.cost));
+  Append(",\"time\":");
+  AppendNumber(summary.time);
+  if (summary.bound >= 0)
+    {
+      Append(",\"lower_bound\":");
+      AppendNumber(static_cast<long>(summary.bound));
+      Append(",\"gap\":");
+      AppendNumber(summary.gap);
+    }
+  // crew of each game
+  Append(",\n\"games\":[");
+  for (j = 0; j < in.Games(); j++)
+    {
+      g = in.GameAt(j);
+      Append(j == 0 ? "\n{\"home\":\"" : ",\n{\"home\":\"");
+      AppendJSON(in.GameHomeTeamCode(g));
+      Append("\",\"guest\":\"");
+      AppendJSON(in.GameGuestTeamCode(g));
+      Append("\",\"date\":\"");
+      AppendJSON(in.GameDate(g));
+      Append("\",\"time\":\"");
+      AppendJSON(in.GameHour(g));
+      Append("\",\"referees\":[");
+      for (i = 0; i < out.AssignedReferees(g).size(); i++)
+        {
+          Append(i == 0 ? "\"" : ",\"");
+          AppendJSON(in.RefereeCode(out.AssignedReferees(g)[i]));
+          Append('"');
+        }
+      Append("]}");
+    }
+  // schedule of each referee, as positions in the games array, in time order
+  Append("],\n\"referees\":[");
+  for (j = 0; j < in.Referees(); j++)
+    {
+      r = in.RefereeAt(j);
+      Append(j == 0 ? "\n{\"code\":\"" : ",\n{\"code\":\"");
+      AppendJSON(in.RefereeCode(r));
+      Append("\",\"games\":[");
+      for (i = 0; i < out.RefereeGames(r).size(); i++)
+        {
+          if (i > 0)
+            Append(',');
+          AppendNumber(static_cast<long>(in.GameFileIndex(out.RefereeGames(r)[i])));
+        }
+      Append("]}");
+    }
+  Append("]}\n");
+}
+
+void RA_Writer::FormatCSV(const RA_Output& out)
+{
+  Append("referee,home,guest,date,time\n");
+  for (unsigned i = 0; i < in.Referees(); i++)
+    for (unsigned g : out.RefereeGames(in.RefereeAt(i)))
+      {
+        AppendCSV(in.RefereeCode(in.RefereeAt(i)));
+        Append(',');
+        AppendCSV(in.GameHomeTeamCode(g));
+        Append(',');
+        AppendCSV(in.GameGuestTeamCode(g));
+        Append(',');
+        AppendCSV(in.GameDate(g));
+        Append(',');
+        AppendCSV(in.GameHour(g));
+        Append('\n');
+      }
+}
+
+bool RA_Writer::FormatBinary(const RA_Output& out, const RA_Summary& summary)
+{
+  // the referee indices and the crew sizes must fit in their fields
+  if (in.Referees() > UINT16_MAX + 1u)
+    {
+      cerr << "Cannot write " << in.Referees() << " referees in the binary format (at most " << UINT16_MAX + 1u << ")" << endl;
+      return false;
+    }
+  for (unsigned g = 0; g < in.Games(); g++)
+    if (out.AssignedReferees(g).size() > UINT8_MAX)
+      {
+        cerr << "Cannot write a crew of " << out.AssignedReferees(g).size() << " referees in the binary format (at most "
+             << UINT8_MAX << ")" << endl;
+        return false;
+      }
+
+  // field by field, so that the file has no padding and does not depend on the host
+  uint64_t time;
+  memcpy(&time, &summary.time, sizeof(time));
+  Append("RAS1", 4);
+  AppendLittleEndian(in.Games(), 4);
+  AppendLittleEndian(in.Referees(), 4);
+  AppendLittleEndian(static_cast<uint32_t>(summary.cost), 4);
+  AppendLittleEndian(static_cast<uint32_t>(summary.bound), 4);
+  AppendLittleEndian(time, 8);
+  for (unsigned i = 0; i < in.Games(); i++)
+    {
+      unsigned g = in.GameAt(i);
+      AppendLittleEndian(out.AssignedReferees(g).size(), 1);
+      for (unsigned r : out.AssignedReferees(g))
+        AppendLittleEndian(in.RefereeFileIndex(r), 2);
+    }
+  return true;
+}
+
+bool RA_Writer::Write(const string& file_name) const
+{
+  int fd = file_name.empty() ? STDOUT_FILENO : open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  size_t written = 0;
+  ssize_t n;
+
+  if (fd == -1)
+    {
+      cerr << "Cannot open output file " << file_name << endl;
+      return false;
+    }
+  cout.flush(); // anything already written to the standard output comes first
+  while (written < size && (n = write(fd, buffer.data() + written, size - written)) > 0)
+    written += n;
+  if (!file_name.empty())
+    close(fd);
+  if (written < size)
+    {
+      cerr << "Cannot write output file " << file_name << endl;
+      return false;
+    }
+  return true;
+}
+
+// Reads an unsigned little-endian number of the given size
+static bool ReadLittleEndian(istream& is, unsigned bytes, uint64_t& v)
+{
+  unsigned char data[8];
+  if (!is.read(reinterpret_cast<char*>(data), bytes))
+    return false;
+  v = 0;
+  for (unsigned i = bytes; i > 0; i--)
+    v = (v << 8) | data[i - 1];
+  return true;
+}
+
+bool ReadBinarySolution(const string& file_name, const RA_Input& in, RA_Output& out)
+{
+  ifstream is(file_name, ios::binary);
+  char magic[4];
+  uint64_t games, referees, summary, crew, r;
+
+  // the summary (cost, bound and time) is skipped
+  if (!is.read(magic, 4) || memcmp(magic, "RAS1", 4) != 0
+      || !ReadLittleEndian(is, 4, games) || !ReadLittleEndian(is, 4, referees)
+      || !ReadLittleEndian(is, 8, summary) || !ReadLittleEndian(is, 8, summary)
+      || games != in.Games() || referees != in.Referees())
+    return false;
+  out.Reset();
+  for (unsigned g = 0; g < in.Games(); g++)
+    {
+      if (!ReadLittleEndian(is, 1, crew))
+        return false;
+      for (unsigned i = 0; i < crew; i++)
+        {
+          if (!ReadLittleEndian(is, 2, r) || r >= in.Referees())
+            return false;
+          out.AssignRefereetoGame(in.GameAt(g), in.RefereeAt(r));
+        }
+    }
+  return true;
+}
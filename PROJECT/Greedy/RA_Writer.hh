@@ -0,0 +1,67 @@
+// File RA_Writer.hh
+#ifndef RA_WRITER_HH
+#define RA_WRITER_HH
+#include "RA_Data.hh"
+#include <cstdint>
+#include <algorithm>
+
+// Output formats of a solution:
+//   text   the format read by operator>>, followed by the Cost:/Time: lines
+//   json   the crew of each game and the schedule of each referee, with the summary
+//   csv    one row per assignment, in the order of the referee schedules
+//   binary a 28-byte header: "RAS1", games (uint32), referees (uint32), cost (int32), lower
+//          bound (int32), time in seconds (IEEE 754 double); then for each game the crew size
+//          (uint8) and the referee indices (uint16), games and referees in the order of the
+//          instance file. All the numbers are little-endian, whatever the host. Instances
+//          with more than 65536 referees or crews of more than 255 cannot be written in it
+// Dates and times are written as in the instance file. Codes, dates and times are escaped in
+// JSON strings, and quoted in CSV fields when they contain a comma, a quote or a newline
+enum class RA_Format { TEXT, JSON, CSV, BINARY };
+
+bool ParseFormat(const string& name, RA_Format& format); // false if the name is unknown
+const char* FormatExtension(RA_Format format);           // ".sol", ".json", ".csv" or ".bin"
+
+// Summary written together with the solution
+struct RA_Summary
+{
+  int cost;
+  double time;     // seconds
+  int bound;       // lower bound, -1 if not computed
+  double gap;      // relative gap from the bound
+};
+
+// Formats a solution into a buffer that is sized once for the instance and reused,
+// and writes it with a single system call
+class RA_Writer
+{
+public:
+  RA_Writer(const RA_Input& in);
+  bool Format(const RA_Output& out, RA_Format format, const RA_Summary& summary); // false if the format cannot hold the solution
+  bool Write(const string& file_name) const; // empty name = standard output
+  const char* Data() const { return buffer.data(); }
+  size_t Size() const { return size; }
+private:
+  const RA_Input& in;
+  vector<char> buffer;
+  size_t size;
+
+  char* Reserve(size_t n);
+  void Append(const char* s, size_t n) { copy(s, s + n, Reserve(n)); size += n; }
+  void Append(const char* s) { Append(s, char_traits<char>::length(s)); }
+  void Append(const string& s) { Append(s.data(), s.size()); }
+  void Append(char c) { *Reserve(1) = c; size++; }
+  void AppendNumber(long n);
+  void AppendNumber(double x);
+  void AppendLittleEndian(uint64_t v, unsigned bytes);
+  void AppendJSON(const string& s); // as the contents of a JSON string
+  void AppendCSV(const string& s);  // as a CSV field
+
+  void FormatText(const RA_Output& out, const RA_Summary& summary);
+  void FormatJSON(const RA_Output& out, const RA_Summary& summary);
+  void FormatCSV(const RA_Output& out);
+  bool FormatBinary(const RA_Output& out, const RA_Summary& summary);
+};
+
+// Reads a solution written in the binary format; false if the file does not match the instance
+bool ReadBinarySolution(const string& file_name, const RA_Input& in, RA_Output& out);
+#endif